@@ -0,0 +1,198 @@
+#ifndef _queue_cpp_
+#define _queue_cpp_
+
+#include "../C_API/syscall_c.hpp"
+
+// Bounded lock-free queues, pushing and popping are a few atomic instructions and the kernel is only
+// entered to wait while a queue is full or empty. Capacity has to be a power of two
+
+// Futex word that threads wait on while an operation can't be done, notify only traps if someone waits
+class QueueEvent
+{
+public:
+    QueueEvent () : sequence(0), waiters(0) { }
+    QueueEvent (const QueueEvent&) = delete;
+    QueueEvent& operator= (const QueueEvent&) = delete;
+
+    // Retries operation until it succeeds, sleeping in between until notify is called
+    template<typename Operation>
+    void waitFor (Operation operation)
+    {
+        if (operation()) return;
+
+        __atomic_fetch_add(&waiters, 1, __ATOMIC_SEQ_CST);
+        while (true)
+        {
+            // Sequence is read before the retry, so a notify that comes after it makes futex_wait return
+            uint32 observed = __atomic_load_n(&sequence, __ATOMIC_SEQ_CST);
+            if (operation()) break;
+
+            futex_wait(&sequence, observed);
+        }
+        __atomic_fetch_sub(&waiters, 1, __ATOMIC_SEQ_CST);
+    }
+
+    // Called after the state a waiter might wait for has changed
+    void notify ()
+    {
+        // Orders the change before reading waiters, a waiter that isn't counted yet sees the change on its retry
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&waiters, __ATOMIC_RELAXED) == 0) return;
+
+        __atomic_fetch_add(&sequence, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&sequence, 1);
+    }
+
+private:
+    uint32 sequence;
+    uint32 waiters;
+};
+
+// One producer and one consumer thread, each side only writes its own index
+template<typename T, uint32 Capacity>
+class SpscQueue
+{
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+public:
+    SpscQueue () : head(0), tail(0) { }
+    SpscQueue (const SpscQueue&) = delete;
+    SpscQueue& operator= (const SpscQueue&) = delete;
+
+    bool tryPush (const T& item)
+    {
+        uint32 currentTail = __atomic_load_n(&tail, __ATOMIC_RELAXED);
+        if (currentTail - __atomic_load_n(&head, __ATOMIC_ACQUIRE) == Capacity) return false;
+
+        slots[currentTail & (Capacity - 1)] = item;
+        __atomic_store_n(&tail, currentTail + 1, __ATOMIC_RELEASE);
+
+        notEmpty.notify();
+        return true;
+    }
+
+    bool tryPop (T& item)
+    {
+        uint32 currentHead = __atomic_load_n(&head, __ATOMIC_RELAXED);
+        if (currentHead == __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) return false;
+
+        item = slots[currentHead & (Capacity - 1)];
+        __atomic_store_n(&head, currentHead + 1, __ATOMIC_RELEASE);
+
+        notFull.notify();
+        return true;
+    }
+
+    void push (const T& item) { notFull.waitFor([&]() { return tryPush(item); }); }
+    void pop (T& item) { notEmpty.waitFor([&]() { return tryPop(item); }); }
+
+private:
+    // Indices only grow and wrap around, they are apart by at most Capacity
+    uint32 head;
+    char headPadding[60];
+    uint32 tail;
+    char tailPadding[60];
+
+    T slots[Capacity];
+
+    QueueEvent notEmpty;
+    QueueEvent notFull;
+};
+
+// Any number of producers and consumers. Every slot has a sequence number that tells which turn of
+// the ring it belongs to, so a slot is claimed with one compare and swap of the shared index
+template<typename T, uint32 Capacity>
+class MpmcQueue
+{
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+
+public:
+    MpmcQueue ()
+        :
+        enqueuePosition(0),
+        dequeuePosition(0)
+    {
+        for (uint32 i = 0; i < Capacity; i++) cells[i].sequence = i;
+    }
+
+    MpmcQueue (const MpmcQueue&) = delete;
+    MpmcQueue& operator= (const MpmcQueue&) = delete;
+
+    bool tryPush (const T& item)
+    {
+        Cell* cell;
+        uint32 position = __atomic_load_n(&enqueuePosition, __ATOMIC_RELAXED);
+        while (true)
+        {
+            cell = &cells[position & (Capacity - 1)];
+            int difference = (int)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - position);
+
+            // Slot is free in this turn, claim it. A failed compare and swap reloads position
+            if (difference == 0)
+            {
+                if (__atomic_compare_exchange_n(&enqueuePosition, &position, position + 1, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+            }
+            // Slot still holds an item from the previous turn
+            else if (difference < 0) return false;
+            // Another producer claimed the slot first
+            else position = __atomic_load_n(&enqueuePosition, __ATOMIC_RELAXED);
+        }
+
+        cell->data = item;
+        __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+
+        notEmpty.notify();
+        return true;
+    }
+
+    bool tryPop (T& item)
+    {
+        Cell* cell;
+        uint32 position = __atomic_load_n(&dequeuePosition, __ATOMIC_RELAXED);
+        while (true)
+        {
+            cell = &cells[position & (Capacity - 1)];
+            int difference = (int)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - (position + 1));
+
+            if (difference == 0)
+            {
+                if (__atomic_compare_exchange_n(&dequeuePosition, &position, position + 1, true,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+            }
+            // Slot wasn't filled in this turn yet
+            else if (difference < 0) return false;
+            else position = __atomic_load_n(&dequeuePosition, __ATOMIC_RELAXED);
+        }
+
+        item = cell->data;
+
+        // Slot is free for the producers of the next turn
+        __atomic_store_n(&cell->sequence, position + Capacity, __ATOMIC_RELEASE);
+
+        notFull.notify();
+        return true;
+    }
+
+    void push (const T& item) { notFull.waitFor([&]() { return tryPush(item); }); }
+    void pop (T& item) { notEmpty.waitFor([&]() { return tryPop(item); }); }
+
+private:
+    struct Cell
+    {
+        uint32 sequence;
+        T data;
+    };
+
+    Cell cells[Capacity];
+
+    uint32 enqueuePosition;
+    char enqueuePadding[60];
+    uint32 dequeuePosition;
+    char dequeuePadding[60];
+
+    QueueEvent notEmpty;
+    QueueEvent notFull;
+};
+
+#endif // _queue_cpp_
@@ -14,14 +14,20 @@ class Thread
 {
 public:
     Thread(void (*body)(void*), void* arg);
+    Thread(void (*body)(void*), void* arg, size_t stackSize);
     virtual ~Thread();
     int start();
     void join();
+    int getStackUsage(size_t* used, size_t* size);
+    int setPriority(int priority);
     static void dispatch();
+    static int yieldTo(Thread* thread);
     static int sleep(time_t);
+    static int sleepUntil(time_t tick);
 
 protected:
     Thread();
+    explicit Thread(size_t stackSize);
     virtual void run() { }
 
 private:
@@ -30,24 +36,167 @@ private:
     thread_t myHandle;
     void (*body)(void*);
     void* arg;
+    size_t stackSize;
 };
 
 class Semaphore
 {
 public:
     explicit Semaphore (unsigned init = 1);
+    Semaphore (unsigned init, unsigned flags);
     virtual ~Semaphore ();
     int wait ();
+    int tryWait ();
+    int timedWait (time_t timeout);
     int signal ();
+    int waitN (unsigned count);
+    int signalN (unsigned count);
 
 private:
     sem_t myHandle;
 };
 
+// Lock and unlock without contention are a single atomic instruction, the kernel is only entered to wait
+class Mutex
+{
+public:
+    Mutex ();
+    Mutex (const Mutex&) = delete;
+    Mutex& operator= (const Mutex&) = delete;
+
+    void lock ();
+    bool tryLock ();
+    void unlock ();
+
+private:
+    // 0 unlocked, 1 locked, 2 locked and someone might be waiting
+    uint32 state;
+};
+
+// Kernel mutex with an owner, a low priority owner is raised to the priority of the threads waiting for it
+class PriorityMutex
+{
+public:
+    PriorityMutex ();
+    virtual ~PriorityMutex ();
+    int lock ();
+    int tryLock ();
+    int unlock ();
+
+private:
+    friend class ConditionVariable;
+
+    mutex_t myHandle;
+};
+
+class ConditionVariable
+{
+public:
+    ConditionVariable ();
+    virtual ~ConditionVariable ();
+    int wait (PriorityMutex& mutex);
+    int signal ();
+    int broadcast ();
+
+private:
+    cond_t myHandle;
+};
+
+class RWLock
+{
+public:
+    explicit RWLock (unsigned flags = RWLOCK_PREFER_WRITERS);
+    virtual ~RWLock ();
+    int readLock ();
+    int writeLock ();
+    int unlock ();
+
+private:
+    rwlock_t myHandle;
+};
+
+class Mailbox
+{
+public:
+    Mailbox (size_t messageSize, size_t capacity);
+    virtual ~Mailbox ();
+    int send (const void* message);
+    int receive (void* message);
+
+private:
+    mbox_t myHandle;
+};
+
+// Byte stream between threads, read and write move what they can, readAll and writeAll keep going
+// until the whole buffer is moved
+class Pipe
+{
+public:
+    explicit Pipe (size_t capacity);
+    virtual ~Pipe ();
+    int read (void* buffer, size_t size);
+    int write (const void* buffer, size_t size);
+    int readAll (void* buffer, size_t size);
+    int writeAll (const void* buffer, size_t size);
+
+private:
+    pipe_t myHandle;
+};
+
+class Barrier
+{
+public:
+    explicit Barrier (unsigned parties);
+    virtual ~Barrier ();
+    int wait ();
+
+private:
+    barrier_t myHandle;
+};
+
+class Latch
+{
+public:
+    explicit Latch (unsigned count);
+    virtual ~Latch ();
+    int countDown (unsigned count = 1);
+    int wait ();
+
+private:
+    latch_t myHandle;
+};
+
+// Base for classes whose public operations run one at a time, each operation starts with a Monitor::Lock
+// and waits for its conditions with wait()
+class Monitor
+{
+protected:
+    class Lock
+    {
+    public:
+        explicit Lock (Monitor& monitor) : monitor(monitor) { monitor.mutex.lock(); }
+        ~Lock () { monitor.mutex.unlock(); }
+
+        Lock (const Lock&) = delete;
+        Lock& operator= (const Lock&) = delete;
+
+    private:
+        Monitor& monitor;
+    };
+
+    int wait (ConditionVariable& condition) { return condition.wait(mutex); }
+
+private:
+    PriorityMutex mutex;
+};
+
 class PeriodicThread : public Thread {
 public:
     void terminate ();
 
+    // Number of releases that were missed because an activation ran too long
+    uint64 getOverruns () const;
+
 protected:
     explicit PeriodicThread (time_t period);
     virtual void periodicActivation () {}
@@ -56,6 +205,7 @@ protected:
 private:
     time_t period;
     bool work;
+    uint64 overruns;
 };
 
 class Console
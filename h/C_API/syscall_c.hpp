@@ -23,16 +23,101 @@
         // returns negative value if it fails
         int thread_create(thread_t* handle, void(*start_routine)(void*), void* arg);
 
+        // Flags for thread_create_flags and thread_create_many
+        #define THREAD_SUSPENDED 0x1 // Thread doesn't run until thread_start is called
+        #define THREAD_FIRST 0x2 // Thread goes in front of the ready threads like with thread_create
+
+        // Same as thread_create, but the current thread keeps the processor and the new thread waits behind
+        // the threads that are already ready, with THREAD_SUSPENDED it doesn't run until thread_start
+        int thread_create_flags(thread_t* handle, void(*start_routine)(void*), void* arg, unsigned flags);
+
+        // Same as thread_create_flags, with a stack of stack_size bytes (0 for the default size)
+        // The kernel adds STACK_CONTEXT_EXTENSION bytes on top of it for its own use
+        int thread_create_with_stack(thread_t* handle, void(*start_routine)(void*), void* arg, size_t stack_size,
+                                     unsigned flags);
+
+        // Get the deepest stack usage of thread_t handle (or the current thread if handle is null) in *used,
+        // and its whole stack size in *size, both including STACK_CONTEXT_EXTENSION
+        // Returns 0 if successful, negative value if it fails
+        int thread_stack_usage(thread_t handle, size_t* used, size_t* size);
+
+        // Start a thread created with THREAD_SUSPENDED, returns negative value if it fails
+        int thread_start(thread_t handle);
+
+        // Create count threads of start_routine in a single system call, thread i gets args[i] (or null if args
+        // is null), handles are returned in handles[0..count-1]
+        // All threads are released together once created (unless THREAD_SUSPENDED is given)
+        // Returns the number of created threads, negative value if it fails
+        int thread_create_many(thread_t* handles, void(*start_routine)(void*), void** args, int count, unsigned flags);
+
+        #define LATENCY_BUCKETS 32
+
+        // Wakeup latencies in nanoseconds, from the moment a thread is made ready until it gets the processor
+        // Percentiles are upper bounds of the histogram bucket they fall in, buckets[i] counts [2^i, 2^(i+1)) ns
+        typedef struct latency_stats
+        {
+            uint64 samples;
+            uint64 max;
+            uint64 average;
+            uint64 p50;
+            uint64 p90;
+            uint64 p99;
+            uint32 buckets[LATENCY_BUCKETS];
+        } latency_stats_t;
+
+        // Get wakeup latency statistics of thread_t handle, or of the whole system if handle is null
+        // Returns 0 if successful, negative value if it fails or the kernel is built without LATENCY_STATS
+        int thread_latency_stats(thread_t handle, latency_stats_t* stats);
+
+        // Set how many exited threads the kernel keeps, together with their stacks, for reuse by thread creation
+        void thread_cache_limit(size_t limit);
+
         // Terminate current thread, returns negative value if it fails
         int thread_exit();
 
         // Let other threads know that they can take over the processor,
-        // does not necesseraly stop the current thread
+        // does not necesseraly stop the current thread and returns without a trap if no other thread is ready
         void thread_dispatch();
 
         // Block current thread until thread_t handle finishes
         void thread_join(thread_t handle);
 
+        // Give the processor directly to thread_t handle, skipping the other threads in the Scheduler
+        // Returns 0 if successful, negative value if handle is not ready to run
+        int thread_yield_to(thread_t handle);
+
+        // Threads of higher priority run first, threads of the same priority take turns
+        #define THREAD_PRIORITY_MIN 0
+        #define THREAD_PRIORITY_DEFAULT 3
+        #define THREAD_PRIORITY_MAX 7
+
+        // Set the priority of thread_t handle, the thread can still run at a higher priority while it holds
+        // a mutex that a higher priority thread waits for
+        // Returns 0 if successful, negative value if it fails
+        int thread_set_priority(thread_t handle, int priority);
+
+        // Restartable sequence, if the thread is preempted while its pc is in [start_ip, start_ip + post_commit_offset)
+        // it continues at abort_ip instead. The last instruction of the sequence is the one that commits its result
+        typedef struct
+        {
+            uint64 start_ip;
+            uint64 post_commit_offset;
+            uint64 abort_ip;
+        } rseq_cs_t;
+
+        // Registered once per thread, cs is set to the descriptor before entering a sequence. The kernel clears it
+        // whenever it preempts the thread, so each entry has to set it again
+        typedef struct
+        {
+            const rseq_cs_t* volatile cs;
+        } rseq_t;
+
+        // Registers the area of the calling thread, null unregisters it
+        // Returns 0 if successful, negative value if it fails
+        int rseq_register(rseq_t* area);
+
+        typedef unsigned long time_t;
+
         class SCB;
         typedef SCB* sem_t;
 
@@ -40,6 +125,18 @@
         // returns negative value if it fails
         int sem_open(sem_t* handle, unsigned init);
 
+        // Flags for sem_open_flags
+        #define SEM_HANDOFF 0x1 // Signal hands the processor to the woken thread
+        #define SEM_LIFO 0x2 // Signal wakes the thread that blocked last, its stack is most likely still in cache
+        #define SEM_PRIORITY 0x4 // Signal wakes the highest priority thread, waiters are woken in FIFO order otherwise
+
+        // Same as sem_open, with additional SEM_* flags
+        int sem_open_flags(sem_t* handle, unsigned init, unsigned flags);
+
+        // Same as sem_open_flags, site is recorded as the call site for lock statistics. Used by wrappers
+        // like the C++ Semaphore so the statistics point at their caller instead of the wrapper
+        int sem_open_at(sem_t* handle, unsigned init, unsigned flags, uint64 site);
+
         // Destroys the semaphore given by sem_t handle
         // Returns 0 if successful, negative value if it fails
         int sem_close(sem_t handle);
@@ -52,14 +149,267 @@
         // Returns 0 if successful, negative value if it fails
         int sem_signal(sem_t id);
 
-        typedef unsigned long time_t;
+        // Results of sem_trywait and sem_timedwait when the semaphore isn't taken
+        #define SEM_BUSY 1
+        #define SEM_TIMEOUT 2
+
+        // Take the semaphore given by sem_t id without blocking
+        // Returns 0 if successful, SEM_BUSY if it would block, negative value if it fails
+        int sem_trywait(sem_t id);
+
+        // Wait for the semaphore given by sem_t id for at most timeout ticks
+        // Returns 0 if signalled, SEM_TIMEOUT if the time ran out, negative value if it fails or the semaphore is closed
+        int sem_timedwait(sem_t id, time_t timeout);
+
+        // Signal count units at once, waiting threads are woken in order as long as there are enough units for them
+        // Returns 0 if successful, negative value if count is 0 or the value of the semaphore would overflow
+        int sem_signal_n(sem_t id, unsigned count);
+
+        // Takes count units at once, only after the threads that waited before it are served
+        // Returns 0 if successful, negative value if it fails or the semaphore is closed while waiting
+        int sem_wait_n(sem_t id, unsigned count);
+
+        // Contention of one semaphore, times are in nanoseconds
+        typedef struct
+        {
+            sem_t handle;
+            uint64 call_site; // Return address of the sem_open call that created it, or the site given to sem_open_at, 0 for the kernel's own
+            uint64 waits; // Wait calls, including sem_trywait and sem_timedwait
+            uint64 blocked; // Wait calls that had to block
+            uint64 blocked_time;
+            uint64 max_blocked_time;
+            uint32 queue_length; // Threads blocked in wait right now
+            uint32 max_queue_length;
+        } lockstat_t;
+
+        // Fills stats with up to count of the most contended semaphores, by total blocked time
+        // Returns the number of filled entries, negative value if it fails or the kernel is built without LOCK_STATS
+        int sem_lockstat(lockstat_t* stats, int count);
 
         int time_sleep (time_t time);
 
+        // Sleep for at least the given number of nanoseconds, timer resolution is 100ns
+        int time_sleep_ns(uint64 nanoseconds);
+
+        // Nanoseconds since reset
+        uint64 time_now_ns();
+
+        // Timer ticks since reset
+        time_t time_now();
+
+        // Sleep until the given tick, returns immediately if it has already passed
+        int time_sleep_until(time_t tick);
+
+        // Kernel keeps this page up to date, user code only reads it and doesn't need a system call for it
+        typedef struct
+        {
+            // Memory mapped timebase counter and its calibration, the tick counter is time / tick_period
+            const volatile uint64* time;
+            uint64 timebase_frequency;
+            uint64 tick_period;
+
+            // Running thread and the number of threads that are ready to take over the processor
+            volatile thread_t current_thread;
+            volatile uint64 runnable;
+        } kernel_info_t;
+
+        const kernel_info_t* kernel_info();
+
+        // Same as time_now and time_now_ns, read from the kernel info page
+        time_t time_now_fast();
+        uint64 time_now_ns_fast();
+
+        // Handle of the calling thread
+        thread_t thread_self();
+
+        class KernelTimer;
+        typedef KernelTimer* timer_t;
+
+        // Creates a timer that calls callback(arg) when it expires, in the dispatcher thread, or in a shared
+        // user-mode dispatcher thread if dispatcher is null. A dispatcher thread has to call timer_dispatch in a loop
+        // Callback can be null for a timer that is only waited on with wait_any
+        // Returns 0 if successful, negative value if it fails
+        int timer_create(timer_t* handle, void (*callback)(void*), void* arg, thread_t dispatcher);
+
+        // Timer expires after delay ticks and then every period ticks, only once if period is 0
+        // Arming an armed timer starts it again
+        int timer_arm(timer_t handle, time_t delay, time_t period);
+
+        // Stops the timer, an expiry that hasn't been dispatched yet is dropped
+        int timer_cancel(timer_t handle);
+
+        int timer_delete(timer_t handle);
+
+        // Waits until a timer dispatched by the calling thread expires and calls its callback
+        int timer_dispatch();
+
         char getc ();
 
         void putc (char output);
 
+        class KernelMutex;
+        typedef KernelMutex* mutex_t;
+
+        // Result of mutex_trylock when another thread holds the mutex
+        #define MUTEX_BUSY 1
+
+        // Creates a mutex that records its owner, the owner runs at least at the priority of the threads that wait for it
+        // Returns 0 if successful, negative value if it fails
+        int mutex_open(mutex_t* handle);
+
+        // Destroys the mutex, threads that still wait for it get a negative value
+        int mutex_close(mutex_t handle);
+
+        // Returns 0 once the mutex is held, negative value if it fails or the calling thread already holds it
+        int mutex_lock(mutex_t handle);
+
+        // Returns 0 if the mutex is taken, MUTEX_BUSY if another thread holds it, negative value if it fails
+        int mutex_trylock(mutex_t handle);
+
+        // Only the owner can unlock, the highest priority waiter gets the mutex next
+        // Returns 0 if successful, negative value if it fails
+        int mutex_unlock(mutex_t handle);
+
+        class KernelCondition;
+        typedef KernelCondition* cond_t;
+
+        // Creates a condition variable, it is waited on while holding a mutex
+        // Returns 0 if successful, negative value if it fails
+        int cond_open(cond_t* handle);
+
+        // Destroys the condition variable, threads that still wait on it get a negative value
+        int cond_close(cond_t handle);
+
+        // Releases the mutex held by the calling thread and waits until signalled, then holds the mutex again
+        // Returns 0 if successful, negative value if it fails or the condition is closed (the mutex isn't held then)
+        int cond_wait(cond_t handle, mutex_t mutex);
+
+        // Wake one or all waiting threads, each continues once it gets the mutex
+        // Returns 0 if successful, negative value if it fails
+        int cond_signal(cond_t handle);
+        int cond_broadcast(cond_t handle);
+
+        class KernelRWLock;
+        typedef KernelRWLock* rwlock_t;
+
+        // Flags for rwlock_open
+        #define RWLOCK_PREFER_WRITERS 0x1 // New readers wait while a writer waits, so writers don't starve
+
+        // Creates a lock that is held by any number of readers or by one writer
+        // Returns 0 if successful, negative value if it fails
+        int rwlock_open(rwlock_t* handle, unsigned flags);
+
+        // Destroys the lock, threads that still wait for it get a negative value
+        int rwlock_close(rwlock_t handle);
+
+        // Returns 0 once the lock is held, negative value if it fails
+        int rwlock_read_lock(rwlock_t handle);
+        int rwlock_write_lock(rwlock_t handle);
+
+        // Releases the lock as a writer if the calling thread is the writer, or else one of its read locks
+        // Returns 0 if successful, negative value if the calling thread is not the writer and holds no read lock
+        int rwlock_unlock(rwlock_t handle);
+
+        class KernelMailbox;
+        typedef KernelMailbox* mbox_t;
+
+        // Creates a mailbox for messages of messageSize bytes that holds up to capacity of them,
+        // with capacity 0 every sender waits for a receiver
+        // Returns 0 if successful, negative value if it fails
+        int mbox_open(mbox_t* handle, size_t messageSize, size_t capacity);
+
+        // Destroys the mailbox, threads that still wait on it get a negative value
+        int mbox_close(mbox_t handle);
+
+        // Copies the message into the mailbox, or straight into a waiting receiver which then runs next
+        // Blocks while the mailbox is full, returns 0 if successful, negative value if it fails
+        int mbox_send(mbox_t handle, const void* message);
+
+        // Copies the oldest message into the buffer, blocks while the mailbox is empty
+        // Returns 0 if successful, negative value if it fails
+        int mbox_recv(mbox_t handle, void* message);
+
+        class KernelPipe;
+        typedef KernelPipe* pipe_t;
+
+        // Creates a byte pipe that buffers up to capacity bytes
+        // Returns 0 if successful, negative value if it fails
+        int pipe_create(pipe_t* handle, size_t capacity);
+
+        // Destroys the pipe, threads that still wait on it get a negative value
+        int pipe_delete(pipe_t handle);
+
+        // Move up to size bytes, blocking only while the pipe is empty for reads or full for writes
+        // Return the number of bytes moved, negative value if it fails
+        int pipe_read(pipe_t handle, void* buffer, size_t size);
+        int pipe_write(pipe_t handle, const void* buffer, size_t size);
+
+        class KernelBarrier;
+        typedef KernelBarrier* barrier_t;
+
+        // Result of barrier_wait for the last thread to arrive, so one thread can do the work between phases
+        #define BARRIER_SERIAL_THREAD 1
+
+        // Creates a barrier for parties threads, it resets by itself once they have all arrived
+        // Returns 0 if successful, negative value if it fails
+        int barrier_open(barrier_t* handle, unsigned parties);
+
+        // Destroys the barrier, threads that still wait on it get a negative value
+        int barrier_close(barrier_t handle);
+
+        // Blocks until all parties have arrived, the last one releases them all at once
+        // Returns BARRIER_SERIAL_THREAD to the last thread and 0 to the others, negative value if it fails
+        int barrier_wait(barrier_t handle);
+
+        class KernelLatch;
+        typedef KernelLatch* latch_t;
+
+        // Creates a latch that opens once it is counted down count times, it stays open after that
+        // Returns 0 if successful, negative value if it fails
+        int latch_open(latch_t* handle, unsigned count);
+
+        // Destroys the latch, threads that still wait on it get a negative value
+        int latch_close(latch_t handle);
+
+        // Counts down by count, the count that reaches zero releases all waiting threads at once
+        // Returns 0 if successful, negative value if it fails
+        int latch_count_down(latch_t handle, unsigned count);
+
+        // Blocks until the latch is open, returns 0 if successful, negative value if it fails
+        int latch_wait(latch_t handle);
+
+        // Result of futex_wait when the word no longer holds the expected value
+        #define FUTEX_CHANGED 1
+
+        // Block while the word at address holds the expected value, until futex_wake is called for it
+        // Returns 0 once woken up, FUTEX_CHANGED if the value was different, negative value if it fails
+        int futex_wait(uint32* address, uint32 expected);
+
+        // Wake up to count threads waiting on the word at address
+        // Returns the number of woken threads, negative value if it fails
+        int futex_wake(uint32* address, int count);
+
+        // Types of sources for wait_any
+        #define WAIT_SEMAPHORE 1 // Handle is a sem_t, waiting takes the semaphore like sem_wait
+        #define WAIT_CONSOLE_INPUT 2 // Handle is ignored but must not be null, fires when getc wouldn't block
+        #define WAIT_TIMER 3 // Handle is a timer_t, fires on its next expiry
+
+        // Result of wait_any when no source fired in time, and the timeout that never runs out
+        #define WAIT_TIMEOUT (-2)
+        #define WAIT_FOREVER ((time_t)-1)
+
+        #define WAIT_ANY_MAX 16
+
+        typedef struct
+        {
+            unsigned type;
+            void* handle;
+        } wait_source_t;
+
+        // Blocks until one of count sources fires or timeout ticks pass, a timeout of 0 only checks the sources
+        // Returns the index of the source that fired, WAIT_TIMEOUT, or negative value if it fails or a source is closed
+        int wait_any(wait_source_t* sources, int count, time_t timeout);
+
     #ifdef __cplusplus
     } // extern "C"
     #endif // __cplusplus
@@ -4,11 +4,13 @@
 #include "../../lib/hw.h"
 #include "../../h/Kernel/KernelDeque.hpp"
 #include "../../h/Kernel/KernelPrinter.hpp"
+#include "../../h/Kernel/WaitQueue.hpp"
 
 class Kernel
 {
     friend class TCB;
     friend class SCB;
+    friend class KernelWaitAny;
 
 public:
     static void initialize();
@@ -55,6 +57,11 @@ public:
     inline static void lock() { Kernel::maskClearSstatus(Kernel::SSTATUS_SIE); }
     inline static void unlock() { Kernel::maskSetSstatus(Kernel::SSTATUS_SIE); }
 
+    static void waitForInterrupt();
+
+    // Read by user code without system calls, see kernel_info
+    alignas(4096) static kernel_info_t info;
+
     static char getCharFromInputBuffer();
     static void addCharToOutputBuffer(char outputChar);
 
@@ -74,7 +81,7 @@ private:
     [[noreturn]] inline static void handleUnknownTrapCause(uint64 scause);
 
     typedef void (*SystemCallHandler)();
-    static constexpr size_t SYSTEM_CALL_HANDLERS_SIZE = 0x42 + 1;
+    static constexpr size_t SYSTEM_CALL_HANDLERS_SIZE = 0x7F + 1;
     static SystemCallHandler systemCallHandlers[];
     static void initializeSystemCallHandlers();
 
@@ -85,13 +92,74 @@ private:
     inline static void handleThreadExit();
     inline static void handleThreadDispatch();
     inline static void handleThreadJoin();
+    inline static void handleThreadYieldTo();
+    inline static void handleThreadCreateFlags();
+    inline static void handleThreadStart();
+    inline static void handleThreadCreateMany();
+    inline static void handleThreadLatencyStats();
+    inline static void handleThreadCacheLimit();
+    inline static void handleThreadStackUsage();
+    inline static void handleThreadSetPriority();
+    inline static void handleRseqRegister();
     inline static void handleSemaphoreOpen();
     inline static void handleSemaphoreClose();
     inline static void handleSemaphoreWait();
     inline static void handleSemaphoreSignal();
+    inline static void handleSemaphoreOpenFlags();
+    inline static void handleSemaphoreTryWait();
+    inline static void handleSemaphoreTimedWait();
+    inline static void handleSemaphoreSignalN();
+    inline static void handleSemaphoreWaitN();
+    inline static void handleSemaphoreLockStats();
     inline static void handleTimeSleep();
+    inline static void handleTimeSleepNs();
+    inline static void handleTimeNowNs();
+    inline static void handleTimeNow();
+    inline static void handleTimeSleepUntil();
+    inline static void handleTimerCreate();
+    inline static void handleTimerArm();
+    inline static void handleTimerCancel();
+    inline static void handleTimerDelete();
+    inline static void handleTimerDispatch();
     inline static void handleGetChar();
     inline static void handlePutChar();
+    inline static void handleFutexWait();
+    inline static void handleFutexWake();
+    inline static void handleWaitAny();
+    inline static void handleMutexOpen();
+    inline static void handleMutexClose();
+    inline static void handleMutexLock();
+    inline static void handleMutexTryLock();
+    inline static void handleMutexUnlock();
+    inline static void handleConditionOpen();
+    inline static void handleConditionClose();
+    inline static void handleConditionWait();
+    inline static void handleConditionSignal();
+    inline static void handleConditionBroadcast();
+    inline static void handleRWLockOpen();
+    inline static void handleRWLockClose();
+    inline static void handleRWLockReadLock();
+    inline static void handleRWLockWriteLock();
+    inline static void handleRWLockUnlock();
+
+    inline static void handleMailboxOpen();
+    inline static void handleMailboxClose();
+    inline static void handleMailboxSend();
+    inline static void handleMailboxReceive();
+
+    inline static void handlePipeCreate();
+    inline static void handlePipeDelete();
+    inline static void handlePipeRead();
+    inline static void handlePipeWrite();
+
+    inline static void handleBarrierOpen();
+    inline static void handleBarrierClose();
+    inline static void handleBarrierWait();
+
+    inline static void handleLatchOpen();
+    inline static void handleLatchClose();
+    inline static void handleLatchCountDown();
+    inline static void handleLatchWait();
 
     static constexpr uint64 SYS_CALL_MEM_ALLOC = 0x01;
     static constexpr uint64 SYS_CALL_MEM_FREE = 0x02;
@@ -99,19 +167,83 @@ private:
     static constexpr uint64 SYS_CALL_THREAD_EXIT = 0x12;
     static constexpr uint64 SYS_CALL_THREAD_DISPATCH = 0x13;
     static constexpr uint64 SYS_CALL_THREAD_JOIN = 0x14;
+    static constexpr uint64 SYS_CALL_THREAD_YIELD_TO = 0x15;
+    static constexpr uint64 SYS_CALL_THREAD_CREATE_FLAGS = 0x16;
+    static constexpr uint64 SYS_CALL_THREAD_START = 0x17;
+    static constexpr uint64 SYS_CALL_THREAD_CREATE_MANY = 0x18;
+    static constexpr uint64 SYS_CALL_THREAD_LATENCY_STATS = 0x19;
+    static constexpr uint64 SYS_CALL_THREAD_CACHE_LIMIT = 0x1A;
+    static constexpr uint64 SYS_CALL_THREAD_STACK_USAGE = 0x1B;
+    static constexpr uint64 SYS_CALL_THREAD_SET_PRIORITY = 0x1C;
+    static constexpr uint64 SYS_CALL_RSEQ_REGISTER = 0x1D;
     static constexpr uint64 SYS_CALL_SEM_OPEN = 0x21;
     static constexpr uint64 SYS_CALL_SEM_CLOSE = 0x22;
     static constexpr uint64 SYS_CALL_SEM_WAIT = 0x23;
     static constexpr uint64 SYS_CALL_SEM_SIGNAL = 0x24;
+    static constexpr uint64 SYS_CALL_SEM_OPEN_FLAGS = 0x25;
+    static constexpr uint64 SYS_CALL_SEM_TRY_WAIT = 0x26;
+    static constexpr uint64 SYS_CALL_SEM_TIMED_WAIT = 0x27;
+    static constexpr uint64 SYS_CALL_SEM_SIGNAL_N = 0x28;
+    static constexpr uint64 SYS_CALL_SEM_WAIT_N = 0x29;
+    static constexpr uint64 SYS_CALL_SEM_LOCKSTAT = 0x2A;
     static constexpr uint64 SYS_CALL_TIME_SLEEP = 0x31;
+    static constexpr uint64 SYS_CALL_TIME_SLEEP_NS = 0x32;
+    static constexpr uint64 SYS_CALL_TIME_NOW_NS = 0x33;
+    static constexpr uint64 SYS_CALL_TIME_NOW = 0x34;
+    static constexpr uint64 SYS_CALL_TIME_SLEEP_UNTIL = 0x35;
+    static constexpr uint64 SYS_CALL_TIMER_CREATE = 0x36;
+    static constexpr uint64 SYS_CALL_TIMER_ARM = 0x37;
+    static constexpr uint64 SYS_CALL_TIMER_CANCEL = 0x38;
+    static constexpr uint64 SYS_CALL_TIMER_DELETE = 0x39;
+    static constexpr uint64 SYS_CALL_TIMER_DISPATCH = 0x3A;
     static constexpr uint64 SYS_CALL_GET_CHAR = 0x41;
     static constexpr uint64 SYS_CALL_PUT_CHAR = 0x42;
+    static constexpr uint64 SYS_CALL_FUTEX_WAIT = 0x51;
+    static constexpr uint64 SYS_CALL_FUTEX_WAKE = 0x52;
+    static constexpr uint64 SYS_CALL_WAIT_ANY = 0x53;
+    static constexpr uint64 SYS_CALL_MUTEX_OPEN = 0x61;
+    static constexpr uint64 SYS_CALL_MUTEX_CLOSE = 0x62;
+    static constexpr uint64 SYS_CALL_MUTEX_LOCK = 0x63;
+    static constexpr uint64 SYS_CALL_MUTEX_TRY_LOCK = 0x64;
+    static constexpr uint64 SYS_CALL_MUTEX_UNLOCK = 0x65;
+    static constexpr uint64 SYS_CALL_COND_OPEN = 0x66;
+    static constexpr uint64 SYS_CALL_COND_CLOSE = 0x67;
+    static constexpr uint64 SYS_CALL_COND_WAIT = 0x68;
+    static constexpr uint64 SYS_CALL_COND_SIGNAL = 0x69;
+    static constexpr uint64 SYS_CALL_COND_BROADCAST = 0x6A;
+    static constexpr uint64 SYS_CALL_RWLOCK_OPEN = 0x6B;
+    static constexpr uint64 SYS_CALL_RWLOCK_CLOSE = 0x6C;
+    static constexpr uint64 SYS_CALL_RWLOCK_READ_LOCK = 0x6D;
+    static constexpr uint64 SYS_CALL_RWLOCK_WRITE_LOCK = 0x6E;
+    static constexpr uint64 SYS_CALL_RWLOCK_UNLOCK = 0x6F;
+
+    static constexpr uint64 SYS_CALL_MBOX_OPEN = 0x71;
+    static constexpr uint64 SYS_CALL_MBOX_CLOSE = 0x72;
+    static constexpr uint64 SYS_CALL_MBOX_SEND = 0x73;
+    static constexpr uint64 SYS_CALL_MBOX_RECV = 0x74;
+
+    static constexpr uint64 SYS_CALL_PIPE_CREATE = 0x75;
+    static constexpr uint64 SYS_CALL_PIPE_DELETE = 0x76;
+    static constexpr uint64 SYS_CALL_PIPE_READ = 0x77;
+    static constexpr uint64 SYS_CALL_PIPE_WRITE = 0x78;
+
+    static constexpr uint64 SYS_CALL_BARRIER_OPEN = 0x79;
+    static constexpr uint64 SYS_CALL_BARRIER_CLOSE = 0x7A;
+    static constexpr uint64 SYS_CALL_BARRIER_WAIT = 0x7B;
+
+    static constexpr uint64 SYS_CALL_LATCH_OPEN = 0x7C;
+    static constexpr uint64 SYS_CALL_LATCH_CLOSE = 0x7D;
+    static constexpr uint64 SYS_CALL_LATCH_COUNT_DOWN = 0x7E;
+    static constexpr uint64 SYS_CALL_LATCH_WAIT = 0x7F;
 
     static volatile KernelDeque<char> inputQueue;
     static constexpr uint16 INPUT_BUFFER_SIZE = 100;
     static SCB* volatile inputEmptySemaphore;
     static SCB* volatile inputFullSemaphore;
 
+    // Threads waiting for console input to become available, without taking it
+    static WaitQueue inputWaiters;
+
     static volatile KernelDeque<char> outputQueue;
     static constexpr uint16 OUTPUT_BUFFER_SIZE = 100;
     static SCB* volatile outputEmptySemaphore;
@@ -190,6 +322,11 @@ inline void Kernel::writeSip(uint64 sip)
     __asm__ volatile ("csrw sip, %[sip]" : : [sip] "r"(sip));
 }
 
+inline void Kernel::waitForInterrupt()
+{
+    __asm__ volatile ("wfi");
+}
+
 inline void Kernel::maskSetSstatus(uint64 mask)
 {
     __asm__ volatile ("csrs sstatus, %[mask]" : : [mask] "r"(mask));
@@ -0,0 +1,28 @@
+#ifndef _Kernel_Barrier_hpp_
+#define _Kernel_Barrier_hpp_
+
+#include "../../lib/hw.h"
+#include "WaitQueue.hpp"
+
+// Barrier for a fixed number of threads, the last one to arrive releases the others in one pass
+// and the barrier is ready for the next phase right away
+class KernelBarrier
+{
+public:
+    static KernelBarrier* createBarrier(unsigned parties);
+    static int deleteBarrier(KernelBarrier* handle);
+
+    // Returns BARRIER_SERIAL_THREAD to the last thread to arrive and 0 to the others,
+    // or a negative value if the barrier is closed while waiting
+    int wait();
+
+private:
+    explicit KernelBarrier(unsigned parties);
+
+    unsigned m_Parties;
+    unsigned m_Arrived;
+
+    WaitQueue m_Waiters;
+};
+
+#endif // _Kernel_Barrier_hpp_
@@ -0,0 +1,31 @@
+#ifndef _Kernel_Condition_hpp_
+#define _Kernel_Condition_hpp_
+
+#include "../../lib/hw.h"
+#include "WaitQueue.hpp"
+
+class KernelMutex;
+
+// Condition variable used together with a KernelMutex, signalled waiters move straight to the queue
+// of the mutex instead of waking up just to block on it again
+class KernelCondition
+{
+public:
+    static KernelCondition* createCondition();
+    static int deleteCondition(KernelCondition* handle);
+
+    // Releases the mutex and waits, returns 0 once signalled and holding the mutex again,
+    // or a negative value if the condition is closed while waiting (the mutex isn't held then)
+    int wait(KernelMutex* mutex);
+
+    int signal();
+    int broadcast();
+
+private:
+    KernelCondition() = default;
+
+    // Nodes are keyed by the mutex their thread has to reacquire
+    WaitQueue m_Waiters;
+};
+
+#endif // _Kernel_Condition_hpp_
@@ -0,0 +1,25 @@
+#ifndef _Kernel_Futex_hpp_
+#define _Kernel_Futex_hpp_
+
+#include "../../lib/hw.h"
+#include "WaitQueue.hpp"
+
+// Waiting on user memory words, user code only traps when it has to block or wake someone up.
+// Waiters are kept in a few queues shared by all addresses, picked by a hash of the address
+class KernelFutex
+{
+public:
+    // Blocks if the word still holds the expected value, returns 0 once woken up or FUTEX_CHANGED
+    static int wait(uint32* address, uint32 expected);
+
+    // Wakes up to count threads waiting on the word, returns how many were woken up
+    static int wake(uint32* address, int count);
+
+private:
+    static WaitQueue* queueFor(const uint32* address);
+
+    static constexpr uint64 QUEUE_COUNT = 64;
+    static WaitQueue queues[QUEUE_COUNT];
+};
+
+#endif // _Kernel_Futex_hpp_
@@ -0,0 +1,28 @@
+#ifndef _Kernel_Latch_hpp_
+#define _Kernel_Latch_hpp_
+
+#include "../../lib/hw.h"
+#include "WaitQueue.hpp"
+
+// Countdown latch, threads wait until the count drops to zero, after that it stays open
+class KernelLatch
+{
+public:
+    static KernelLatch* createLatch(unsigned count);
+    static int deleteLatch(KernelLatch* handle);
+
+    // Counting down past zero stops at zero, the count that reaches zero releases all waiters in one pass
+    int countDown(unsigned count);
+
+    // Returns 0 once the count is zero, or a negative value if the latch is closed while waiting
+    int wait();
+
+private:
+    explicit KernelLatch(unsigned count);
+
+    unsigned m_Count;
+
+    WaitQueue m_Waiters;
+};
+
+#endif // _Kernel_Latch_hpp_
@@ -0,0 +1,38 @@
+#ifndef _Kernel_Mailbox_hpp_
+#define _Kernel_Mailbox_hpp_
+
+#include "../../lib/hw.h"
+#include "WaitQueue.hpp"
+
+// Bounded queue of fixed size messages copied by the kernel. Messages for a waiting receiver skip the
+// ring and go straight into its buffer, and a waiting sender's message goes into the slot a receiver frees
+class KernelMailbox
+{
+public:
+    static KernelMailbox* createMailbox(size_t messageSize, size_t capacity);
+    static int deleteMailbox(KernelMailbox* handle);
+
+    // Return 0 once the message is passed on, or a negative value if the mailbox is closed while waiting
+    int send(const void* message);
+    int receive(void* message);
+
+private:
+    KernelMailbox(size_t messageSize, size_t capacity, char* ring);
+
+    char* slot(size_t index) const { return m_Ring + (index % m_Capacity) * m_MessageSize; }
+    void copy(void* destination, const void* source) const;
+
+    size_t m_MessageSize;
+    size_t m_Capacity;
+
+    // Ring of m_Capacity messages, allocated together with the mailbox
+    char* m_Ring;
+    size_t m_Head;
+    size_t m_Count;
+
+    // Receivers only wait while the ring is empty and senders while it is full, nodes are keyed by their buffers
+    WaitQueue m_Receivers;
+    WaitQueue m_Senders;
+};
+
+#endif // _Kernel_Mailbox_hpp_
@@ -0,0 +1,57 @@
+#ifndef _Kernel_Mutex_hpp_
+#define _Kernel_Mutex_hpp_
+
+#include "../../lib/hw.h"
+#include "WaitQueue.hpp"
+
+class TCB;
+
+// Mutex that knows its owner, the owner runs at least at the priority of its highest priority waiter,
+// also through chains of owners that wait for other mutexes
+class KernelMutex
+{
+public:
+    static KernelMutex* createMutex();
+    static int deleteMutex(KernelMutex* handle);
+
+    // Lock returns 0 once the mutex is held, or a negative value if the mutex is closed while waiting
+    int lock();
+    int tryLock();
+    int unlock();
+
+    // Mutexes of a thread that exits go to their highest priority waiters, nobody could unlock them later
+    static void releaseAll(TCB* thread);
+
+    // Thread blocked on the node waits for the mutex from now on, it is woken up once it holds the mutex
+    void acquireFor(WaitQueue::Node* node);
+
+    TCB* getOwner() const { return m_Owner; }
+
+    // Effective priority of the thread is recalculated from its base priority and the mutexes it holds,
+    // the change is carried on to the owners it waits for
+    static void updatePriority(TCB* thread);
+
+private:
+    KernelMutex();
+
+    // Highest priority waiter gets the mutex, the one that waited the longest among equals
+    WaitQueue::Node* highestWaiter() const;
+    int ceilingPriority() const;
+
+    // Owner and everyone it waits for run at least at the priority of a new waiter
+    void inheritPriority(int priority);
+
+    void giveTo(TCB* thread);
+    void release();
+
+    // Releases the mutex and gives it to the highest priority waiter, if there is one
+    void handOver();
+
+    TCB* m_Owner;
+    WaitQueue m_Waiters;
+
+    // Next mutex held by the same owner
+    KernelMutex* m_NextHeld;
+};
+
+#endif // _Kernel_Mutex_hpp_
@@ -0,0 +1,33 @@
+#ifndef _Kernel_Pipe_hpp_
+#define _Kernel_Pipe_hpp_
+
+#include "../../lib/hw.h"
+#include "WaitQueue.hpp"
+
+// Byte stream between threads over a ring buffer, every call moves as much of the buffer as fits
+// and only blocks while the pipe is empty for reads or full for writes
+class KernelPipe
+{
+public:
+    static KernelPipe* createPipe(size_t capacity);
+    static int deletePipe(KernelPipe* handle);
+
+    // Return the number of bytes moved, or a negative value if the pipe is closed while waiting
+    int read(void* buffer, size_t size);
+    int write(const void* buffer, size_t size);
+
+private:
+    KernelPipe(size_t capacity, char* ring);
+
+    size_t m_Capacity;
+
+    // Ring of m_Capacity bytes, allocated together with the pipe
+    char* m_Ring;
+    size_t m_Head;
+    size_t m_Count;
+
+    WaitQueue m_Readers;
+    WaitQueue m_Writers;
+};
+
+#endif // _Kernel_Pipe_hpp_
@@ -0,0 +1,40 @@
+#ifndef _Kernel_RW_Lock_hpp_
+#define _Kernel_RW_Lock_hpp_
+
+#include "../../lib/hw.h"
+#include "WaitQueue.hpp"
+
+class TCB;
+
+// Lock held by any number of readers or by one writer. Readers only queue when they can't enter, and the
+// readers that waited are admitted together. With writer preference new readers queue behind waiting
+// writers, after a writer all readers that waited still go first so neither side starves
+class KernelRWLock
+{
+public:
+    static KernelRWLock* createRWLock(bool preferWriters);
+    static int deleteRWLock(KernelRWLock* handle);
+
+    // Return 0 once the lock is held, or a negative value if the lock is closed while waiting
+    int readLock();
+    int writeLock();
+
+    // Releases the lock the way the calling thread holds it, returns a negative value if the thread is not
+    // the writer and holds no read lock
+    int unlock();
+
+private:
+    explicit KernelRWLock(bool preferWriters);
+
+    void admitReaders();
+
+    // Read locks that are held, a thread that reads recursively is counted more than once
+    int m_Readers;
+    TCB* m_Writer;
+    bool m_PreferWriters;
+
+    WaitQueue m_WaitingReaders;
+    WaitQueue m_WaitingWriters;
+};
+
+#endif // _Kernel_RW_Lock_hpp_
@@ -0,0 +1,77 @@
+#ifndef _Kernel_Timer_hpp_
+#define _Kernel_Timer_hpp_
+
+#include "../../lib/hw.h"
+#include "TimerQueue.hpp"
+#include "WaitQueue.hpp"
+
+class TCB;
+
+// Timer that calls a callback in a dispatcher thread when it expires, instead of a thread sleeping for it.
+// Timers without a dispatcher are served by one shared thread, a dispatcher thread given by the user has
+// to call timer_dispatch in a loop, its timers move to the shared thread once it exits. Timers without
+// a callback are only waited on
+class KernelTimer
+{
+    friend class KernelWaitAny;
+
+public:
+    using Callback = void(*)(void*);
+
+    static KernelTimer* createTimer(Callback callback, void* args, TCB* dispatcher);
+    static int deleteTimer(KernelTimer* handle);
+
+    // Expires after delay ticks and then every period ticks, once if period is 0
+    int arm(uint64 delay, uint64 period);
+    int cancel();
+
+    // Blocks the running thread until one of the timers it dispatches expires
+    static KernelTimer* waitExpired();
+
+    // Called when a dispatcher thread exits, its timers and their undispatched expiries go to the shared
+    // dispatcher. If that can't be created the timers lose their callbacks and are only waited on
+    static void detachDispatcher(TCB* thread);
+
+    Callback getCallback() const { return m_Callback; }
+    void* getArgs() const { return m_Args; }
+
+private:
+    KernelTimer(Callback callback, void* args, TCB* dispatcher);
+
+    static void expired(TimerQueue::Entry* entry);
+
+    void queue();
+    void unqueue();
+
+    void attach(TCB* dispatcher);
+    void detach();
+
+    // Created the first time a timer needs it, null if that fails
+    static TCB* getSharedDispatcher();
+
+    [[noreturn]] static void dispatcherThreadBody(void*);
+
+    Callback m_Callback;
+    void* m_Args;
+    TCB* m_Dispatcher;
+
+    // Next timer of the same dispatcher
+    KernelTimer* m_NextDispatched;
+
+    TimerQueue::Entry m_Entry;
+
+    // Expiry and period in timebase units, periodic timers are rearmed from the previous expiry
+    uint64 m_Expiry;
+    uint64 m_Period;
+
+    // Expired timers wait for their dispatcher in a list, a timer that is already there isn't added again
+    bool m_Pending;
+    KernelTimer* m_NextPending;
+
+    // Threads waiting for the next expiry
+    WaitQueue m_Waiters;
+
+    static TCB* sharedDispatcher;
+};
+
+#endif // _Kernel_Timer_hpp_
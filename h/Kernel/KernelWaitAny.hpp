@@ -0,0 +1,25 @@
+#ifndef _Kernel_Wait_Any_hpp_
+#define _Kernel_Wait_Any_hpp_
+
+#include "../../lib/hw.h"
+#include "../../h/C_API/syscall_c.hpp"
+#include "WaitQueue.hpp"
+
+// Waiting on several sources at once, the thread gets a node in the wait queue of every source and
+// the first one to fire takes it out of all the others
+class KernelWaitAny
+{
+public:
+    // Returns the index of the source that fired, WAIT_TIMEOUT or a negative value if some source was closed
+    static int waitAny(wait_source_t* sources, int count, time_t timeout);
+
+private:
+    // Returns the index of the first source that is already ready, or -1
+    static int findReady(wait_source_t* sources, int count);
+
+    static WaitQueue* queueOf(const wait_source_t& source);
+
+    static constexpr int MAX_SOURCES = WAIT_ANY_MAX;
+};
+
+#endif // _Kernel_Wait_Any_hpp_
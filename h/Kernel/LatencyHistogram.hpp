@@ -0,0 +1,24 @@
+#ifndef _Latency_Histogram_hpp_
+#define _Latency_Histogram_hpp_
+
+#include "../C_API/syscall_c.hpp"
+
+// Log-scale histogram of latencies in nanoseconds, bucket i counts latencies in [2^i, 2^(i+1))
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(uint64 latency);
+    void getStats(latency_stats_t* stats) const;
+
+private:
+    uint64 percentile(uint64 percent) const;
+
+    uint64 m_Samples;
+    uint64 m_Total;
+    uint64 m_Max;
+    uint32 m_Buckets[LATENCY_BUCKETS];
+};
+
+#endif // _Latency_Histogram_hpp_
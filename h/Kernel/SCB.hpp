@@ -2,26 +2,89 @@
 #define _SCB_hpp_
 
 #include "TCB.hpp"
-#include "KernelDeque.hpp"
+#include "WaitQueue.hpp"
 
 class SCB
 {
+    friend class KernelWaitAny;
+
 public:
-    explicit SCB(unsigned startValue = 1, bool binary = false);
+    // Which waiter a signal wakes: the one that waited the longest, the one that blocked last and still
+    // has its data in cache, or the one with the highest priority
+    enum WakePolicy { WAKE_FIFO, WAKE_LIFO, WAKE_PRIORITY };
+
+    explicit SCB(unsigned startValue = 1, bool binary = false, bool handoff = false, WakePolicy policy = WAKE_FIFO);
     ~SCB();
 
-    void wait();
-    void signal();
+    // Return 0 once the semaphore is taken, SEM_BUSY or SEM_TIMEOUT if it isn't,
+    // or a negative value if it is closed while waiting. Count units are taken at once
+    int wait(unsigned count = 1);
+    int tryWait();
+    int timedWait(uint64 timeout);
+
+    // Returns a negative value if count is 0 or the value would overflow
+    int signal(unsigned count = 1);
+
+    // Fills stats with the count most contended semaphores, by total blocked time, returns how many were filled
+    // or a negative value if the kernel is built without LOCK_STATS
+    static int getLockStats(lockstat_t* stats, int count);
+
+    // Return address of the code that created the semaphore, ignored without LOCK_STATS
+#if LOCK_STATS
+    void setCallSite(uint64 callSite) { m_CallSite = callSite; }
+#else
+    void setCallSite(uint64) { }
+#endif
 
 protected:
-    void block();
-    void unblock();
+    // Waiters are always served first, so nobody takes units while others wait
+    bool canTake(unsigned count) const { return m_BlockedQueue.isEmpty() && m_Value >= (int)count; }
+
+    // Timeout is in timebase units, 0 waits forever
+    int block(unsigned count = 1, uint64 timeout = 0);
+    void serveWaiters();
+    WaitQueue::Node* nextWaiter() const;
+
+    // Bookkeeping for a waiter that leaves the queue is done here, the blocked thread itself must not touch
+    // the semaphore once it is woken up, it could be closed before the thread runs
+    static void waiterLeft(void* owner, WaitQueue::Node* node, int status);
 
+    // Never negative, blocked threads are only counted by the queue. Units stay here while the
+    // first waiter asks for more than there are
     int m_Value;
     bool m_Binary;
 
+    static constexpr int MAX_VALUE = 0x7FFFFFFF;
+
+    // Woken threads are handed the processor instead of waiting at the back of the Scheduler
+    bool m_Handoff;
+
+    WakePolicy m_Policy;
+
 private:
-    KernelDeque<TCB*> m_BlockedQueue;
+    WaitQueue m_BlockedQueue;
+
+#if LOCK_STATS
+    void recordWait() { m_Waits++; }
+
+    // 0 for the kernel's own semaphores
+    uint64 m_CallSite;
+
+    // Blocked time is in timebase units, queue length counts threads blocked in wait
+    uint64 m_Waits;
+    uint64 m_Blocked;
+    uint64 m_BlockedTime;
+    uint64 m_MaxBlockedTime;
+    uint32 m_QueueLength;
+    uint32 m_MaxQueueLength;
+
+    // All semaphores, so the most contended ones can be found
+    SCB* m_PrevSemaphore;
+    SCB* m_NextSemaphore;
+    static SCB* allSemaphores;
+#else
+    void recordWait() { }
+#endif
 };
 
 #endif //_SCB_hpp_
@@ -8,11 +8,18 @@ class TCB;
 class Scheduler
 {
 private:
-    static KernelDeque<TCB*> threadQueue;
+    // One queue per priority, threads of the highest priority that is ready take turns
+    static constexpr int PRIORITY_LEVELS = THREAD_PRIORITY_MAX + 1;
+    static KernelDeque<TCB*> threadQueues[PRIORITY_LEVELS];
+
+    // Thread that was handed the processor directly, it runs before anything in the queue
+    static TCB* handoffThread;
 
 public:
     static TCB *get();
     static void put(TCB *handle, bool putAtFrontOfQueue = false);
+    static void handoff(TCB *handle);
+    static int remove(TCB *handle);
     static bool contains(TCB *handle);
     static bool isEmpty();
 };
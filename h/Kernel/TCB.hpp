@@ -3,17 +3,35 @@
 
 #include "../../lib/hw.h"
 #include "Scheduler.hpp"
+#include "LatencyHistogram.hpp"
+#include "TimerQueue.hpp"
+#include "WaitQueue.hpp"
+
+class KernelTimer;
+class KernelMutex;
 
 class TCB
 {
     friend class Kernel;
     friend class SCB;
+    friend class Timer;
+    friend class KernelTimer;
+    friend class KernelMutex;
+    friend class KernelRWLock;
+    friend class KernelWaitAny;
     friend void PeriodicThread::terminate();
 
 public:
     using Body = void(*)(void*);
 
-    static TCB* createThread(Body body, void* args, void* stack, bool kernelThread = false);
+    // Stack size doesn't include STACK_CONTEXT_EXTENSION, it is always added for kernel code
+    static TCB* createThread(Body body, void* args, void* stack, bool kernelThread = false, bool suspended = false,
+                             size_t stackSize = DEFAULT_STACK_SIZE);
+    static int createThreads(TCB** handles, Body body, void** args, int count, bool suspended);
+
+    int start(bool putAtFrontOfQueue = false);
+
+    int getStackUsage(size_t* used, size_t* size) const;
 
     static KernelDeque<TCB*> allThreads;
     static KernelDeque<TCB*> suspendedThreads;
@@ -24,10 +42,29 @@ public:
 
     static int sleep(uint64);
 
+    // Blocks the running thread in the queue until it is woken up or the timeout (in timebase units,
+    // 0 is forever) expires, returns the status it was woken up with
+    static int block(WaitQueue* queue, const void* key = nullptr, uint64 timeout = 0);
+
+    // Same as block, for nodes (chained through sibling) the caller has already put in their queues
+    static int blockQueued(WaitQueue::Node* nodes, uint64 timeout = 0);
+
+    // Index is the index of the node the thread is woken up through
+    void wake(int status, bool handoff = false, int index = 0);
+
+    static int yieldTo(TCB* handle);
+
+    int getPriority() const { return m_Priority; }
+    static int setPriority(TCB* handle, int priority);
+
+    static int getLatencyStats(TCB* handle, latency_stats_t* stats);
+
+    static void setThreadCacheLimit(uint64 limit);
+
     ~TCB();
 
 private:
-    TCB(Body body, void* args, uint64 timeSlice, void* stack, bool kernelThread = false);
+    TCB(Body body, void* args, uint64 timeSlice, void* stack, size_t stackSize, bool kernelThread = false);
 
     struct Context
     {
@@ -38,14 +75,61 @@ private:
     Body m_Body;
     void* m_Args;
     void* m_Stack;
+    size_t m_StackSize;
     Context m_Context;
     uint64 m_TimeSlice;
+    bool m_Started;
     bool m_Finished;
     KernelDeque<TCB*> m_WaitingThreads;
-    uint64 m_SleepCounter;
+    TimerQueue::Entry m_TimeoutEntry;
+
+    // Priority the thread was given and the one it runs at, which can be raised by the mutexes it holds
+    int m_BasePriority;
+    int m_Priority;
+
+    // Mutex the thread waits for and the list of mutexes it holds, for priority inheritance
+    KernelMutex* m_BlockedOnMutex;
+    KernelMutex* m_HeldMutexes;
+
+    // Read locks of KernelRWLocks the thread holds
+    int m_ReadLocks;
+
+    void setEffectivePriority(int priority);
+
+    // Restartable sequence area registered by the thread, or null
+    rseq_t* m_Rseq;
+
+    // Returns where a thread preempted at pc has to resume, the abort handler if pc is inside its sequence
+    uint64 abortSequence(uint64 pc);
+
+    // Node of the queue the thread is blocked in, so a timeout can take it out, and why it was woken up
+    WaitQueue::Node* m_WaitNode;
+    int m_WakeStatus;
+    int m_WakeIndex;
+
+    void leaveWaitQueues(int status);
+
     bool m_PutInScheduler;
     bool m_KernelThread;
 
+    // Expired timers this thread dispatches
+    KernelTimer* m_ExpiredTimers;
+    KernelTimer* m_ExpiredTimersTail;
+    bool m_WaitingForTimers;
+
+    // Timers this thread dispatches, they are handed to the shared dispatcher when it exits
+    KernelTimer* m_Timers;
+
+#if LATENCY_STATS
+    // Time when the thread was made ready after blocking or sleeping, 0 if it wasn't
+    uint64 m_WakeupTime;
+    LatencyHistogram m_WakeupLatency;
+
+    static LatencyHistogram wakeupLatency;
+#endif
+
+    void markWakeup();
+
     static TCB* mainThread;
     static TCB* idleThread;
     static TCB* outputThread;
@@ -58,11 +142,38 @@ private:
 
     static void contextSwitch(Context* oldContext, Context* newContext);
 
+    static void timeoutExpired(TimerQueue::Entry* entry);
+
     static void dispatch();
     static int deleteThread(TCB* handle);
 
-    static uint64 timeSliceCounter;
+    // Dispatch from kernel code, thread_dispatch can return without a trap when nothing else is ready,
+    // which would leave a blocking thread running
+    static void yield();
+
+    // Exited threads are kept together with their stacks and reused by createThread
+    static TCB* threadCache;
+    static uint64 threadCacheSize;
+    static uint64 threadCacheLimit;
+    static constexpr uint64 DEFAULT_THREAD_CACHE_LIMIT = 16;
+    TCB* m_NextCached;
+
+    static TCB* allocateThread(void*& stack, size_t stackSize);
+
+    // Unused stack memory keeps this pattern, so the deepest point the stack has reached can be found
+    static constexpr uint64 STACK_PAINT_PATTERN = 0x57AC57AC57AC57ACUL;
+    static void paintStack(void* stack, size_t stackSize);
+    static void releaseThread(TCB* handle);
+
+    // Time when the running thread's time slice ends, in timebase units
+    static uint64 timeSliceEnd;
 };
 
 
+inline void TCB::yield()
+{
+    // Ecall from supervisor mode always dispatches, the trap doesn't restore A0 and A1
+    __asm__ volatile ("ecall" : : : "a0", "a1", "memory");
+}
+
 #endif //_TCB_hpp_
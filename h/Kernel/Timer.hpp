@@ -0,0 +1,61 @@
+#ifndef _Timer_hpp_
+#define _Timer_hpp_
+
+#include "../../lib/hw.h"
+
+// Program stimecmp directly, the firmware has to enable Sstc for supervisor mode
+#ifndef TIMER_SSTC
+#define TIMER_SSTC 0
+#endif
+
+// Scheduler tick in Hz, time_sleep counts in these ticks
+#ifndef TICK_FREQUENCY
+#define TICK_FREQUENCY 10
+#endif
+
+class Timer
+{
+public:
+    static void initialize();
+
+    // Time since reset in timebase units
+    static uint64 now();
+
+    // Program the next timer interrupt for the nearest event, which is the end of the running thread's
+    // time slice if other threads are ready, or the nearest timeout
+    static void program();
+
+    static uint64 toNanoseconds(uint64 time);
+    static uint64 fromNanoseconds(uint64 nanoseconds);
+
+    // Frequency of the machine timer on QEMU virt
+    static constexpr uint64 TIMEBASE_FREQUENCY = 10000000UL;
+    static constexpr uint64 NANOSECONDS_PER_TIME_UNIT = 1000000000UL / TIMEBASE_FREQUENCY;
+    static constexpr uint64 TICK_PERIOD = TIMEBASE_FREQUENCY / TICK_FREQUENCY;
+
+private:
+    static void setCompare(uint64 time);
+
+    // Longest time without a timer interrupt, even when there is nothing to wait for
+    static constexpr uint64 MAX_IDLE_PERIOD = TIMEBASE_FREQUENCY;
+
+    static constexpr uint64 CLINT_MTIME = 0x200BFF8UL;
+};
+
+inline uint64 Timer::now()
+{
+    // The time CSR isn't enabled for supervisor mode by the firmware, so read the memory mapped counter
+    return *((uint64 volatile*)CLINT_MTIME);
+}
+
+inline uint64 Timer::toNanoseconds(uint64 time)
+{
+    return time * NANOSECONDS_PER_TIME_UNIT;
+}
+
+inline uint64 Timer::fromNanoseconds(uint64 nanoseconds)
+{
+    return (nanoseconds + NANOSECONDS_PER_TIME_UNIT - 1) / NANOSECONDS_PER_TIME_UNIT;
+}
+
+#endif // _Timer_hpp_
@@ -0,0 +1,50 @@
+#ifndef _Timer_Queue_hpp_
+#define _Timer_Queue_hpp_
+
+#include "../../lib/hw.h"
+
+// Delta queue of timeouts, every entry keeps the time between its expiry and the expiry of the entry
+// before it (the head counts from the last update), so an update only has to look at the head of the queue
+class TimerQueue
+{
+public:
+    struct Entry
+    {
+        using Callback = void(*)(Entry*);
+
+        Entry* prev;
+        Entry* next;
+        uint64 delta;
+        bool queued;
+
+        Callback expire;
+        void* owner;
+
+        Entry(Callback expire, void* owner)
+            :
+            prev(nullptr),
+            next(nullptr),
+            delta(0),
+            queued(false),
+            expire(expire),
+            owner(owner)
+        {
+        }
+    };
+
+    // Entry expires after delay timebase units
+    static void insert(Entry* entry, uint64 delay);
+    static void remove(Entry* entry);
+
+    // Expire callbacks of entries that are due are called in order
+    static void update();
+
+    static bool nextExpiry(uint64& time);
+    static bool isEmpty();
+
+private:
+    static Entry* head;
+    static uint64 lastUpdate;
+};
+
+#endif // _Timer_Queue_hpp_
@@ -0,0 +1,80 @@
+#ifndef _Wait_Queue_hpp_
+#define _Wait_Queue_hpp_
+
+#include "../../lib/hw.h"
+
+class TCB;
+
+// Queue of blocked threads, nodes live on the stacks of the waiting threads so any waiter can be
+// taken out in constant time, for example when its timeout expires
+class WaitQueue
+{
+public:
+    struct Node
+    {
+        Node* prev;
+        Node* next;
+        WaitQueue* queue;
+        TCB* thread;
+
+        // What the thread waits for, when one queue is shared by different objects
+        const void* key;
+
+        // Thread waiting in several queues has a node in each, the one that wakes it up reports its index
+        int index;
+        Node* sibling;
+
+        // How many units the thread waits for, for objects that hand out several at once
+        unsigned count;
+
+#if LOCK_STATS
+        // When the thread blocked, 0 if the owner of the queue doesn't keep statistics
+        uint64 blockedAt;
+#endif
+
+        explicit Node(TCB* thread, const void* key = nullptr, int index = 0)
+            :
+            prev(nullptr),
+            next(nullptr),
+            queue(nullptr),
+            thread(thread),
+            key(key),
+            index(index),
+            sibling(nullptr),
+            count(1)
+#if LOCK_STATS
+            ,
+            blockedAt(0)
+#endif
+        {
+        }
+    };
+
+    // Called when a woken thread leaves the queue, with the status it is woken with. The owner is still
+    // alive at that point, unlike once the thread runs again
+    using LeaveHandler = void(*)(void* owner, Node* node, int status);
+
+    explicit WaitQueue(LeaveHandler leaveHandler = nullptr, void* owner = nullptr);
+
+    WaitQueue(const WaitQueue&) = delete;
+    WaitQueue& operator=(const WaitQueue&) = delete;
+
+    void addLast(Node* node);
+    Node* removeFirst();
+    void remove(Node* node);
+
+    Node* first() const;
+    Node* last() const;
+    bool isEmpty() const;
+
+    void left(Node* node, int status) { if(leaveHandler != nullptr) leaveHandler(owner, node, status); }
+
+private:
+    Node* head;
+    Node* tail;
+
+    LeaveHandler leaveHandler;
+    void* owner;
+};
+
+#endif // _Wait_Queue_hpp_
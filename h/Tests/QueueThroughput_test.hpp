@@ -0,0 +1,6 @@
+#ifndef XV6_QUEUETHROUGHPUT_TEST_HPP
+#define XV6_QUEUETHROUGHPUT_TEST_HPP
+
+void testQueueThroughput();
+
+#endif //XV6_QUEUETHROUGHPUT_TEST_HPP
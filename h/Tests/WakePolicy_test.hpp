@@ -0,0 +1,6 @@
+#ifndef XV6_WAKEPOLICY_TEST_HPP
+#define XV6_WAKEPOLICY_TEST_HPP
+
+void testWakePolicy();
+
+#endif //XV6_WAKEPOLICY_TEST_HPP
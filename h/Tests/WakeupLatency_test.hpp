@@ -0,0 +1,6 @@
+#ifndef XV6_WAKEUPLATENCY_TEST_HPP
+#define XV6_WAKEUPLATENCY_TEST_HPP
+
+void testWakeupLatency();
+
+#endif //XV6_WAKEUPLATENCY_TEST_HPP
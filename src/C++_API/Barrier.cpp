@@ -0,0 +1,18 @@
+#include "../../h/C++_API/syscall_cpp.hpp"
+
+Barrier::Barrier(unsigned parties)
+    :
+    myHandle(nullptr)
+{
+    barrier_open(&myHandle, parties);
+}
+
+Barrier::~Barrier()
+{
+    barrier_close(myHandle);
+}
+
+int Barrier::wait()
+{
+    return barrier_wait(myHandle);
+}
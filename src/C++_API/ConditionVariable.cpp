@@ -0,0 +1,28 @@
+#include "../../h/C++_API/syscall_cpp.hpp"
+
+ConditionVariable::ConditionVariable()
+    :
+    myHandle(nullptr)
+{
+    cond_open(&myHandle);
+}
+
+ConditionVariable::~ConditionVariable()
+{
+    cond_close(myHandle);
+}
+
+int ConditionVariable::wait(PriorityMutex& mutex)
+{
+    return cond_wait(myHandle, mutex.myHandle);
+}
+
+int ConditionVariable::signal()
+{
+    return cond_signal(myHandle);
+}
+
+int ConditionVariable::broadcast()
+{
+    return cond_broadcast(myHandle);
+}
@@ -0,0 +1,23 @@
+#include "../../h/C++_API/syscall_cpp.hpp"
+
+Latch::Latch(unsigned count)
+    :
+    myHandle(nullptr)
+{
+    latch_open(&myHandle, count);
+}
+
+Latch::~Latch()
+{
+    latch_close(myHandle);
+}
+
+int Latch::countDown(unsigned count)
+{
+    return latch_count_down(myHandle, count);
+}
+
+int Latch::wait()
+{
+    return latch_wait(myHandle);
+}
@@ -0,0 +1,23 @@
+#include "../../h/C++_API/syscall_cpp.hpp"
+
+Mailbox::Mailbox(size_t messageSize, size_t capacity)
+    :
+    myHandle(nullptr)
+{
+    mbox_open(&myHandle, messageSize, capacity);
+}
+
+Mailbox::~Mailbox()
+{
+    mbox_close(myHandle);
+}
+
+int Mailbox::send(const void* message)
+{
+    return mbox_send(myHandle, message);
+}
+
+int Mailbox::receive(void* message)
+{
+    return mbox_recv(myHandle, message);
+}
@@ -0,0 +1,32 @@
+#include "../../h/C++_API/syscall_cpp.hpp"
+
+Mutex::Mutex()
+    :
+    state(0)
+{
+}
+
+void Mutex::lock()
+{
+    uint32 expected = 0;
+    if(__atomic_compare_exchange_n(&state, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return;
+
+    // Contended, mark that someone waits so the owner knows to wake it up
+    if(expected != 2) expected = __atomic_exchange_n(&state, 2, __ATOMIC_ACQUIRE);
+    while(expected != 0)
+    {
+        futex_wait(&state, 2);
+        expected = __atomic_exchange_n(&state, 2, __ATOMIC_ACQUIRE);
+    }
+}
+
+bool Mutex::tryLock()
+{
+    uint32 expected = 0;
+    return __atomic_compare_exchange_n(&state, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+void Mutex::unlock()
+{
+    if(__atomic_exchange_n(&state, 0, __ATOMIC_RELEASE) == 2) futex_wake(&state, 1);
+}
@@ -9,15 +9,34 @@ void PeriodicThread::terminate()
 PeriodicThread::PeriodicThread(time_t period)
     :
     period(period),
-    work(true)
+    work(true),
+    overruns(0)
 {
 }
 
+uint64 PeriodicThread::getOverruns() const
+{
+    return overruns;
+}
+
 void PeriodicThread::run()
 {
+    // Releases are counted from a fixed epoch, so time spent in activations doesn't add up
+    auto release = time_now();
     while(work)
     {
         periodicActivation();
-        time_sleep(period);
+        release += period;
+
+        // Releases that have already passed are skipped and counted instead of stretching the period
+        auto now = time_now();
+        if(period != 0 && now > release)
+        {
+            auto missed = (now - release + period - 1) / period;
+            overruns += missed;
+            release += missed * period;
+        }
+
+        time_sleep_until(release);
     }
 }
\ No newline at end of file
@@ -0,0 +1,49 @@
+#include "../../h/C++_API/syscall_cpp.hpp"
+
+Pipe::Pipe(size_t capacity)
+    :
+    myHandle(nullptr)
+{
+    pipe_create(&myHandle, capacity);
+}
+
+Pipe::~Pipe()
+{
+    pipe_delete(myHandle);
+}
+
+int Pipe::read(void* buffer, size_t size)
+{
+    return pipe_read(myHandle, buffer, size);
+}
+
+int Pipe::write(const void* buffer, size_t size)
+{
+    return pipe_write(myHandle, buffer, size);
+}
+
+int Pipe::readAll(void* buffer, size_t size)
+{
+    size_t done = 0;
+    while(done < size)
+    {
+        auto moved = pipe_read(myHandle, (char*)buffer + done, size - done);
+        if(moved < 0) return moved;
+        done += moved;
+    }
+
+    return 0;
+}
+
+int Pipe::writeAll(const void* buffer, size_t size)
+{
+    size_t done = 0;
+    while(done < size)
+    {
+        auto moved = pipe_write(myHandle, (const char*)buffer + done, size - done);
+        if(moved < 0) return moved;
+        done += moved;
+    }
+
+    return 0;
+}
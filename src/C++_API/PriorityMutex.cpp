@@ -0,0 +1,28 @@
+#include "../../h/C++_API/syscall_cpp.hpp"
+
+PriorityMutex::PriorityMutex()
+    :
+    myHandle(nullptr)
+{
+    mutex_open(&myHandle);
+}
+
+PriorityMutex::~PriorityMutex()
+{
+    mutex_close(myHandle);
+}
+
+int PriorityMutex::lock()
+{
+    return mutex_lock(myHandle);
+}
+
+int PriorityMutex::tryLock()
+{
+    return mutex_trylock(myHandle);
+}
+
+int PriorityMutex::unlock()
+{
+    return mutex_unlock(myHandle);
+}
@@ -0,0 +1,28 @@
+#include "../../h/C++_API/syscall_cpp.hpp"
+
+RWLock::RWLock(unsigned int flags)
+    :
+    myHandle(nullptr)
+{
+    rwlock_open(&myHandle, flags);
+}
+
+RWLock::~RWLock()
+{
+    rwlock_close(myHandle);
+}
+
+int RWLock::readLock()
+{
+    return rwlock_read_lock(myHandle);
+}
+
+int RWLock::writeLock()
+{
+    return rwlock_write_lock(myHandle);
+}
+
+int RWLock::unlock()
+{
+    return rwlock_unlock(myHandle);
+}
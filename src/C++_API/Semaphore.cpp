@@ -4,7 +4,14 @@ Semaphore::Semaphore(unsigned int init)
     :
     myHandle(nullptr)
 {
-    sem_open(&myHandle, init);
+    sem_open_at(&myHandle, init, 0, (uint64)__builtin_return_address(0));
+}
+
+Semaphore::Semaphore(unsigned int init, unsigned int flags)
+    :
+    myHandle(nullptr)
+{
+    sem_open_at(&myHandle, init, flags, (uint64)__builtin_return_address(0));
 }
 
 Semaphore::~Semaphore()
@@ -17,7 +24,27 @@ int Semaphore::wait()
     return sem_wait(myHandle);
 }
 
+int Semaphore::tryWait()
+{
+    return sem_trywait(myHandle);
+}
+
+int Semaphore::timedWait(time_t timeout)
+{
+    return sem_timedwait(myHandle, timeout);
+}
+
 int Semaphore::signal()
 {
     return sem_signal(myHandle);
 }
+
+int Semaphore::waitN(unsigned count)
+{
+    return sem_wait_n(myHandle, count);
+}
+
+int Semaphore::signalN(unsigned count)
+{
+    return sem_signal_n(myHandle, count);
+}
@@ -3,13 +3,27 @@
 Thread::Thread(void (*body)(void *), void *arg)
     :
     body(body),
-    arg(arg)
+    arg(arg),
+    stackSize(0)
 {
     // Can't create main thread, it gets created by the system
     if(body == nullptr) return;
     thread_create(&myHandle, body, arg);
 }
 
+Thread::Thread(void (*body)(void *), void *arg, size_t stackSize)
+    :
+    body(body),
+    arg(arg),
+    stackSize(stackSize)
+{
+    if(body == nullptr) return;
+
+    // Runs first, the same way thread_create starts threads
+    thread_create_with_stack(&myHandle, body, arg, stackSize, THREAD_FIRST);
+    thread_dispatch();
+}
+
 Thread::~Thread()
 {
 }
@@ -21,7 +35,12 @@ int Thread::start()
     body = &runWrapper;
     arg = this;
 
-    return thread_create(&myHandle, body, arg);
+    if(stackSize == 0) return thread_create(&myHandle, body, arg);
+
+    auto returnValue = thread_create_with_stack(&myHandle, body, arg, stackSize, THREAD_FIRST);
+    thread_dispatch();
+
+    return returnValue;
 }
 
 void Thread::join()
@@ -29,14 +48,38 @@ void Thread::join()
     thread_join(myHandle);
 }
 
+int Thread::getStackUsage(size_t* used, size_t* size)
+{
+    return thread_stack_usage(myHandle, used, size);
+}
+
+int Thread::setPriority(int priority)
+{
+    return thread_set_priority(myHandle, priority);
+}
+
 void Thread::dispatch()
 {
     thread_dispatch();
 }
 
+int Thread::yieldTo(Thread* thread)
+{
+    if(thread == nullptr) return -1;
+    return thread_yield_to(thread->myHandle);
+}
+
 Thread::Thread()
     :
-    body(nullptr)
+    body(nullptr),
+    stackSize(0)
+{
+}
+
+Thread::Thread(size_t stackSize)
+    :
+    body(nullptr),
+    stackSize(stackSize)
 {
 }
 
@@ -49,4 +92,9 @@ void Thread::runWrapper(void *args)
 int Thread::sleep(time_t time)
 {
     return time_sleep(time);
+}
+
+int Thread::sleepUntil(time_t tick)
+{
+    return time_sleep_until(tick);
 }
\ No newline at end of file
@@ -28,52 +28,76 @@ int mem_free(void* ptr) { return (int)systemCall(0x02, ptr); }
 
 int thread_create(thread_t* handle, void(*start_routine)(void*), void* arg)
 {
-    // Store arguments starting from A1
-    __asm__ volatile ("mv a3, a2");
-    __asm__ volatile ("mv a2, a1");
+    // Null stack in A6 lets the kernel give the thread a stack, possibly one of a thread that has exited
+    // (A4 will get overwritten on the way to the system call handler)
+    auto returnValue = (int)systemCall(0x11, handle, start_routine, arg, 0, 0, nullptr);
 
-    // Save handle to A7, it will be overwritten by alloc
-    __asm__ volatile ("mv a7, a0");
-    // Save args to A6, it will be overwritten by alloc
-    __asm__ volatile ("mv a6, a3");
+    // Thread create should also start the new thread
+    thread_dispatch();
 
-    // Allocate stack for thread, A1 will be overwritten here
-    // Stack context extension has enough space for deepest nesting of kernel code
-    void* stack = MemoryAllocator::alloc(DEFAULT_STACK_SIZE + STACK_CONTEXT_EXTENSION);
-    if(stack == 0) return -1;
+    return returnValue;
+}
 
-    // Restore handle from A7
-    __asm__ volatile ("mv a1, a7");
-    // Restore args from A6
-    __asm__ volatile ("mv a3, a6");
+// A4 and A5 get overwritten on the way to the system call handler, so the arguments after the
+// third one are passed in A6 and A7
+int thread_create_flags(thread_t* handle, void(*start_routine)(void*), void* arg, unsigned flags)
+{
+    return (int)systemCall(0x16, handle, start_routine, arg, 0, 0, flags, 0);
+}
 
-    // Store stack argument to A6 (A4 will get overwritten by some local variable)
-    __asm__ volatile ("mv a6, %[inStack]" : : [inStack] "r" (stack));
+int thread_create_with_stack(thread_t* handle, void(*start_routine)(void*), void* arg, size_t stack_size,
+                             unsigned flags)
+{
+    return (int)systemCall(0x16, handle, start_routine, arg, 0, 0, flags, stack_size);
+}
 
-    // Store the system call code in register A0
-    // This will invalidate the local stack variable, because mem_alloc returns value in A0
-    __asm__ volatile ("li a0, 0x11");
+int thread_stack_usage(thread_t handle, size_t* used, size_t* size) { return (int)systemCall(0x1B, handle, used, size); }
 
-    // Generate interrupt
-    __asm__ volatile ("ecall");
+int thread_set_priority(thread_t handle, int priority) { return (int)systemCall(0x1C, handle, priority); }
 
-    // Get the return value after ECALL
-    int volatile returnValue;
-    __asm__ volatile ("mv %[outReturn], a0" : [outReturn] "=r" (returnValue));
+int rseq_register(rseq_t* area) { return (int)systemCall(0x1D, area); }
 
-    // Thread create should also start the new thread
-    thread_dispatch();
+int thread_start(thread_t handle) { return (int)systemCall(0x17, handle); }
 
-    return returnValue;
+int thread_create_many(thread_t* handles, void(*start_routine)(void*), void** args, int count, unsigned flags)
+{
+    return (int)systemCall(0x18, handles, start_routine, args, 0, 0, count, flags);
 }
 
+int thread_latency_stats(thread_t handle, latency_stats_t* stats) { return (int)systemCall(0x19, handle, stats); }
+
+void thread_cache_limit(size_t limit) { systemCall(0x1A, limit); }
+
 int thread_exit() { return (int)systemCall(0x12); }
 
-void thread_dispatch() { systemCall(0x13); }
+void thread_dispatch()
+{
+    // Nobody to give the processor to
+    if(Kernel::info.runnable == 0) return;
+
+    systemCall(0x13);
+}
 
 void thread_join(thread_t handle) { systemCall(0x14, handle); }
 
-int sem_open(sem_t* handle, unsigned init) { return (int)systemCall(0x21, handle, init); }
+int thread_yield_to(thread_t handle) { return (int)systemCall(0x15, handle); }
+
+int sem_open(sem_t* handle, unsigned init)
+{
+    // Caller is recorded as the call site for lock statistics
+    return (int)systemCall(0x21, handle, init, __builtin_return_address(0));
+}
+
+int sem_open_flags(sem_t* handle, unsigned init, unsigned flags)
+{
+    return sem_open_at(handle, init, flags, (uint64)__builtin_return_address(0));
+}
+
+int sem_open_at(sem_t* handle, unsigned init, unsigned flags, uint64 site)
+{
+    // (A4 will get overwritten on the way to the system call handler)
+    return (int)systemCall(0x25, handle, init, flags, 0, 0, site);
+}
 
 int sem_close(sem_t handle) { return (int)systemCall(0x22, handle); }
 
@@ -81,8 +105,123 @@ int sem_wait(sem_t id) { return (int)systemCall(0x23, id); }
 
 int sem_signal(sem_t id) { return (int)systemCall(0x24, id); }
 
+int sem_trywait(sem_t id) { return (int)systemCall(0x26, id); }
+
+int sem_timedwait(sem_t id, time_t timeout) { return (int)systemCall(0x27, id, timeout); }
+
+int sem_signal_n(sem_t id, unsigned count) { return (int)systemCall(0x28, id, count); }
+
+int sem_wait_n(sem_t id, unsigned count) { return (int)systemCall(0x29, id, count); }
+
+int sem_lockstat(lockstat_t* stats, int count) { return (int)systemCall(0x2A, stats, count); }
+
 int time_sleep(time_t time) { return (int)systemCall(0x31, time); }
 
+int time_sleep_ns(uint64 nanoseconds) { return (int)systemCall(0x32, nanoseconds); }
+
+uint64 time_now_ns() { return systemCall(0x33); }
+
+time_t time_now() { return (time_t)systemCall(0x34); }
+
+int time_sleep_until(time_t tick) { return (int)systemCall(0x35, tick); }
+
+const kernel_info_t* kernel_info() { return &Kernel::info; }
+
+time_t time_now_fast() { return *Kernel::info.time / Kernel::info.tick_period; }
+
+uint64 time_now_ns_fast() { return *Kernel::info.time * (1000000000UL / Kernel::info.timebase_frequency); }
+
+thread_t thread_self() { return Kernel::info.current_thread; }
+
+int timer_create(timer_t* handle, void (*callback)(void*), void* arg, thread_t dispatcher)
+{
+    return (int)systemCall(0x36, handle, callback, arg, 0, 0, dispatcher);
+}
+
+int timer_arm(timer_t handle, time_t delay, time_t period) { return (int)systemCall(0x37, handle, delay, period); }
+
+int timer_cancel(timer_t handle) { return (int)systemCall(0x38, handle); }
+
+int timer_delete(timer_t handle) { return (int)systemCall(0x39, handle); }
+
+int timer_dispatch()
+{
+    void (*callback)(void*);
+    void* arg;
+
+    auto result = (int)systemCall(0x3A, &callback, &arg);
+    if(result < 0) return result;
+
+    callback(arg);
+    return 0;
+}
+
 char getc() { return (char) systemCall(0x41); }
 
-void putc(char output) { systemCall(0x42, output); }
\ No newline at end of file
+void putc(char output) { systemCall(0x42, output); }
+
+int futex_wait(uint32* address, uint32 expected) { return (int)systemCall(0x51, address, expected); }
+
+int futex_wake(uint32* address, int count) { return (int)systemCall(0x52, address, count); }
+
+int wait_any(wait_source_t* sources, int count, time_t timeout) { return (int)systemCall(0x53, sources, count, timeout); }
+
+int mutex_open(mutex_t* handle) { return (int)systemCall(0x61, handle); }
+
+int mutex_close(mutex_t handle) { return (int)systemCall(0x62, handle); }
+
+int mutex_lock(mutex_t handle) { return (int)systemCall(0x63, handle); }
+
+int mutex_trylock(mutex_t handle) { return (int)systemCall(0x64, handle); }
+
+int mutex_unlock(mutex_t handle) { return (int)systemCall(0x65, handle); }
+
+int cond_open(cond_t* handle) { return (int)systemCall(0x66, handle); }
+
+int cond_close(cond_t handle) { return (int)systemCall(0x67, handle); }
+
+int cond_wait(cond_t handle, mutex_t mutex) { return (int)systemCall(0x68, handle, mutex); }
+
+int cond_signal(cond_t handle) { return (int)systemCall(0x69, handle); }
+
+int cond_broadcast(cond_t handle) { return (int)systemCall(0x6A, handle); }
+
+int rwlock_open(rwlock_t* handle, unsigned flags) { return (int)systemCall(0x6B, handle, flags); }
+
+int rwlock_close(rwlock_t handle) { return (int)systemCall(0x6C, handle); }
+
+int rwlock_read_lock(rwlock_t handle) { return (int)systemCall(0x6D, handle); }
+
+int rwlock_write_lock(rwlock_t handle) { return (int)systemCall(0x6E, handle); }
+
+int rwlock_unlock(rwlock_t handle) { return (int)systemCall(0x6F, handle); }
+
+int mbox_open(mbox_t* handle, size_t messageSize, size_t capacity) { return (int)systemCall(0x71, handle, messageSize, capacity); }
+
+int mbox_close(mbox_t handle) { return (int)systemCall(0x72, handle); }
+
+int mbox_send(mbox_t handle, const void* message) { return (int)systemCall(0x73, handle, message); }
+
+int mbox_recv(mbox_t handle, void* message) { return (int)systemCall(0x74, handle, message); }
+
+int pipe_create(pipe_t* handle, size_t capacity) { return (int)systemCall(0x75, handle, capacity); }
+
+int pipe_delete(pipe_t handle) { return (int)systemCall(0x76, handle); }
+
+int pipe_read(pipe_t handle, void* buffer, size_t size) { return (int)systemCall(0x77, handle, buffer, size); }
+
+int pipe_write(pipe_t handle, const void* buffer, size_t size) { return (int)systemCall(0x78, handle, buffer, size); }
+
+int barrier_open(barrier_t* handle, unsigned parties) { return (int)systemCall(0x79, handle, parties); }
+
+int barrier_close(barrier_t handle) { return (int)systemCall(0x7A, handle); }
+
+int barrier_wait(barrier_t handle) { return (int)systemCall(0x7B, handle); }
+
+int latch_open(latch_t* handle, unsigned count) { return (int)systemCall(0x7C, handle, count); }
+
+int latch_close(latch_t handle) { return (int)systemCall(0x7D, handle); }
+
+int latch_count_down(latch_t handle, unsigned count) { return (int)systemCall(0x7E, handle, count); }
+
+int latch_wait(latch_t handle) { return (int)systemCall(0x7F, handle); }
\ No newline at end of file
@@ -1,6 +1,20 @@
 #include "../../h/Kernel/Kernel.hpp"
 #include "../../h/Kernel/TCB.hpp"
 #include "../../h/Kernel/SCB.hpp"
+#include "../../h/Kernel/TimerQueue.hpp"
+#include "../../h/Kernel/Timer.hpp"
+#include "../../h/Kernel/KernelTimer.hpp"
+#include "../../h/Kernel/KernelFutex.hpp"
+#include "../../h/Kernel/KernelMutex.hpp"
+#include "../../h/Kernel/KernelCondition.hpp"
+#include "../../h/Kernel/KernelRWLock.hpp"
+#include "../../h/Kernel/KernelWaitAny.hpp"
+#include "../../h/Kernel/KernelMailbox.hpp"
+#include "../../h/Kernel/KernelPipe.hpp"
+#include "../../h/Kernel/KernelBarrier.hpp"
+#include "../../h/Kernel/KernelLatch.hpp"
+
+kernel_info_t Kernel::info = {};
 
 uint64 Kernel::oldTrapHandler = 0;
 
@@ -9,6 +23,7 @@ Kernel::SystemCallHandler Kernel::systemCallHandlers[SYSTEM_CALL_HANDLERS_SIZE]
 volatile KernelDeque<char> Kernel::inputQueue;
 SCB* volatile Kernel::inputEmptySemaphore;
 SCB* volatile Kernel::inputFullSemaphore;
+WaitQueue Kernel::inputWaiters;
 
 volatile KernelDeque<char> Kernel::outputQueue;
 SCB* volatile Kernel::outputEmptySemaphore;
@@ -22,6 +37,7 @@ void Kernel::initialize()
 
     oldTrapHandler = readStvec();
     writeStvec((uint64)&supervisorTrap + 1);
+    Timer::initialize();
 
     initializeSystemThreads();
     initializeIO();
@@ -71,7 +87,7 @@ void Kernel::initializeIO()
 
     // Enable interrupts
     maskSetSstatus(SSTATUS_SIE);
-    thread_dispatch();
+    TCB::yield();
 }
 
 void Kernel::initializeUserThread()
@@ -80,7 +96,7 @@ void Kernel::initializeUserThread()
 
     auto userThreadStack = MemoryAllocator::alloc(DEFAULT_STACK_SIZE + STACK_CONTEXT_EXTENSION);
     TCB::userThread = TCB::createThread([](void*) { userMain(); }, nullptr, userThreadStack);
-    thread_dispatch();
+    TCB::yield();
 
     // Wait for user thread to finish
     TCB::running->waitForThread(TCB::userThread);
@@ -107,28 +123,26 @@ void Kernel::handleTimerTrap()
     maskClearSip(SIP_SSIP);
     if(TCB::running == nullptr) return;
 
-    for(auto it = TCB::allThreads.head; it != nullptr; it = it->next)
-    {
-        if(it->data->m_SleepCounter == 0) continue;
-        if(--(it->data->m_SleepCounter) == 0)
-        {
-            Scheduler::put(it->data);
-        }
-    }
+    // Only timeouts that are due are touched
+    TimerQueue::update();
 
-    TCB::timeSliceCounter++;
-    if(TCB::timeSliceCounter >= TCB::running->m_TimeSlice)
+    // Time slice only ends if there is someone to give the processor to
+    if(!Scheduler::isEmpty() && Timer::now() >= TCB::timeSliceEnd)
     {
         auto volatile sepc = readSepc();
         auto volatile sstatus = readSstatus();
 
-        TCB::timeSliceCounter = 0;
+        // User thread preempted inside a restartable sequence resumes at its abort handler
+        if(!(sstatus & SSTATUS_SPP)) sepc = TCB::running->abortSequence(sepc);
+
         TCB::dispatch();
 
         // Restore important supervisor registers
         writeSstatus(sstatus);
         writeSepc(sepc);
     }
+
+    Timer::program();
 }
 
 void Kernel::handleExternalTrap()
@@ -156,6 +170,12 @@ void Kernel::handleExternalTrap()
             if(pInData == '\r') pInData = '\n';
             inputQueue.addLast(pInData);
             inputFullSemaphore->signal();
+
+            while(!inputWaiters.isEmpty())
+            {
+                auto node = inputWaiters.first();
+                node->thread->wake(0, false, node->index);
+            }
         }
     }
 
@@ -214,13 +234,74 @@ void Kernel::initializeSystemCallHandlers()
     systemCallHandlers[SYS_CALL_THREAD_EXIT] = handleThreadExit;
     systemCallHandlers[SYS_CALL_THREAD_DISPATCH] = handleThreadDispatch;
     systemCallHandlers[SYS_CALL_THREAD_JOIN] = handleThreadJoin;
+    systemCallHandlers[SYS_CALL_THREAD_YIELD_TO] = handleThreadYieldTo;
+    systemCallHandlers[SYS_CALL_THREAD_CREATE_FLAGS] = handleThreadCreateFlags;
+    systemCallHandlers[SYS_CALL_THREAD_START] = handleThreadStart;
+    systemCallHandlers[SYS_CALL_THREAD_CREATE_MANY] = handleThreadCreateMany;
+    systemCallHandlers[SYS_CALL_THREAD_LATENCY_STATS] = handleThreadLatencyStats;
+    systemCallHandlers[SYS_CALL_THREAD_CACHE_LIMIT] = handleThreadCacheLimit;
+    systemCallHandlers[SYS_CALL_THREAD_STACK_USAGE] = handleThreadStackUsage;
+    systemCallHandlers[SYS_CALL_THREAD_SET_PRIORITY] = handleThreadSetPriority;
+    systemCallHandlers[SYS_CALL_RSEQ_REGISTER] = handleRseqRegister;
     systemCallHandlers[SYS_CALL_SEM_OPEN] = handleSemaphoreOpen;
     systemCallHandlers[SYS_CALL_SEM_CLOSE] = handleSemaphoreClose;
     systemCallHandlers[SYS_CALL_SEM_WAIT] = handleSemaphoreWait;
     systemCallHandlers[SYS_CALL_SEM_SIGNAL] = handleSemaphoreSignal;
+    systemCallHandlers[SYS_CALL_SEM_OPEN_FLAGS] = handleSemaphoreOpenFlags;
+    systemCallHandlers[SYS_CALL_SEM_TRY_WAIT] = handleSemaphoreTryWait;
+    systemCallHandlers[SYS_CALL_SEM_TIMED_WAIT] = handleSemaphoreTimedWait;
+    systemCallHandlers[SYS_CALL_SEM_SIGNAL_N] = handleSemaphoreSignalN;
+    systemCallHandlers[SYS_CALL_SEM_WAIT_N] = handleSemaphoreWaitN;
+    systemCallHandlers[SYS_CALL_SEM_LOCKSTAT] = handleSemaphoreLockStats;
     systemCallHandlers[SYS_CALL_TIME_SLEEP] = handleTimeSleep;
+    systemCallHandlers[SYS_CALL_TIME_SLEEP_NS] = handleTimeSleepNs;
+    systemCallHandlers[SYS_CALL_TIME_NOW_NS] = handleTimeNowNs;
+    systemCallHandlers[SYS_CALL_TIME_NOW] = handleTimeNow;
+    systemCallHandlers[SYS_CALL_TIME_SLEEP_UNTIL] = handleTimeSleepUntil;
+    systemCallHandlers[SYS_CALL_TIMER_CREATE] = handleTimerCreate;
+    systemCallHandlers[SYS_CALL_TIMER_ARM] = handleTimerArm;
+    systemCallHandlers[SYS_CALL_TIMER_CANCEL] = handleTimerCancel;
+    systemCallHandlers[SYS_CALL_TIMER_DELETE] = handleTimerDelete;
+    systemCallHandlers[SYS_CALL_TIMER_DISPATCH] = handleTimerDispatch;
     systemCallHandlers[SYS_CALL_GET_CHAR] = handleGetChar;
     systemCallHandlers[SYS_CALL_PUT_CHAR] = handlePutChar;
+    systemCallHandlers[SYS_CALL_FUTEX_WAIT] = handleFutexWait;
+    systemCallHandlers[SYS_CALL_FUTEX_WAKE] = handleFutexWake;
+    systemCallHandlers[SYS_CALL_WAIT_ANY] = handleWaitAny;
+    systemCallHandlers[SYS_CALL_MUTEX_OPEN] = handleMutexOpen;
+    systemCallHandlers[SYS_CALL_MUTEX_CLOSE] = handleMutexClose;
+    systemCallHandlers[SYS_CALL_MUTEX_LOCK] = handleMutexLock;
+    systemCallHandlers[SYS_CALL_MUTEX_TRY_LOCK] = handleMutexTryLock;
+    systemCallHandlers[SYS_CALL_MUTEX_UNLOCK] = handleMutexUnlock;
+    systemCallHandlers[SYS_CALL_COND_OPEN] = handleConditionOpen;
+    systemCallHandlers[SYS_CALL_COND_CLOSE] = handleConditionClose;
+    systemCallHandlers[SYS_CALL_COND_WAIT] = handleConditionWait;
+    systemCallHandlers[SYS_CALL_COND_SIGNAL] = handleConditionSignal;
+    systemCallHandlers[SYS_CALL_COND_BROADCAST] = handleConditionBroadcast;
+    systemCallHandlers[SYS_CALL_RWLOCK_OPEN] = handleRWLockOpen;
+    systemCallHandlers[SYS_CALL_RWLOCK_CLOSE] = handleRWLockClose;
+    systemCallHandlers[SYS_CALL_RWLOCK_READ_LOCK] = handleRWLockReadLock;
+    systemCallHandlers[SYS_CALL_RWLOCK_WRITE_LOCK] = handleRWLockWriteLock;
+    systemCallHandlers[SYS_CALL_RWLOCK_UNLOCK] = handleRWLockUnlock;
+
+    systemCallHandlers[SYS_CALL_MBOX_OPEN] = handleMailboxOpen;
+    systemCallHandlers[SYS_CALL_MBOX_CLOSE] = handleMailboxClose;
+    systemCallHandlers[SYS_CALL_MBOX_SEND] = handleMailboxSend;
+    systemCallHandlers[SYS_CALL_MBOX_RECV] = handleMailboxReceive;
+
+    systemCallHandlers[SYS_CALL_PIPE_CREATE] = handlePipeCreate;
+    systemCallHandlers[SYS_CALL_PIPE_DELETE] = handlePipeDelete;
+    systemCallHandlers[SYS_CALL_PIPE_READ] = handlePipeRead;
+    systemCallHandlers[SYS_CALL_PIPE_WRITE] = handlePipeWrite;
+
+    systemCallHandlers[SYS_CALL_BARRIER_OPEN] = handleBarrierOpen;
+    systemCallHandlers[SYS_CALL_BARRIER_CLOSE] = handleBarrierClose;
+    systemCallHandlers[SYS_CALL_BARRIER_WAIT] = handleBarrierWait;
+
+    systemCallHandlers[SYS_CALL_LATCH_OPEN] = handleLatchOpen;
+    systemCallHandlers[SYS_CALL_LATCH_CLOSE] = handleLatchClose;
+    systemCallHandlers[SYS_CALL_LATCH_COUNT_DOWN] = handleLatchCountDown;
+    systemCallHandlers[SYS_CALL_LATCH_WAIT] = handleLatchWait;
 }
 
 void Kernel::handleSystemCalls(uint64 systemCallCode, uint64 scause)
@@ -309,21 +390,171 @@ void Kernel::handleThreadJoin()
     TCB::running->waitForThread(handle);
 }
 
-void Kernel::handleSemaphoreOpen()
+void Kernel::handleThreadYieldTo()
 {
-    // Save handle to A7, it will be overwritten by alloc
-    __asm__ volatile ("mv a7, a1");
+    TCB* volatile handle;
 
-    auto newSCB = static_cast<SCB*>(MemoryAllocator::alloc(sizeof(SCB)));
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = TCB::yieldTo(handle);
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleThreadCreateFlags()
+{
+    TCB** volatile handle;
+    TCB::Body volatile routine;
+    void* volatile args;
+    unsigned volatile flags;
+    size_t volatile stackSize;
+
+    // Get arguments, flags and stack size are passed in A6 and A7 because A4 and A5 don't survive the trap
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outRoutine], a2" : [outRoutine] "=r" (routine));
+    __asm__ volatile ("mv %[outArgs], a3" : [outArgs] "=r" (args));
+    __asm__ volatile ("mv %[outFlags], a6" : [outFlags] "=r" (flags));
+    __asm__ volatile ("mv %[outStackSize], a7" : [outStackSize] "=r" (stackSize));
+
+    if(stackSize == 0) stackSize = DEFAULT_STACK_SIZE;
+    auto newTCB = TCB::createThread(routine, args, nullptr, false, true, stackSize);
+
+    // Creator keeps the processor, the new thread waits behind the ones that are already ready unless it goes first
+    if(newTCB != nullptr && !(flags & THREAD_SUSPENDED)) newTCB->start(flags & THREAD_FIRST);
+
+    *handle = newTCB;
+    auto returnValue = (*handle == nullptr ? -1 : 0);
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleThreadStart()
+{
+    TCB* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = TCB::allThreads.contains(handle) ? handle->start() : -1;
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleThreadCreateMany()
+{
+    TCB** volatile handles;
+    TCB::Body volatile routine;
+    void** volatile args;
+    int volatile count;
+    unsigned volatile flags;
+
+    // Get arguments, count and flags are passed in A6 and A7 because A4 and A5 don't survive the trap
+    __asm__ volatile ("mv %[outHandles], a1" : [outHandles] "=r" (handles));
+    __asm__ volatile ("mv %[outRoutine], a2" : [outRoutine] "=r" (routine));
+    __asm__ volatile ("mv %[outArgs], a3" : [outArgs] "=r" (args));
+    __asm__ volatile ("mv %[outCount], a6" : [outCount] "=r" (count));
+    __asm__ volatile ("mv %[outFlags], a7" : [outFlags] "=r" (flags));
+
+    auto returnValue = TCB::createThreads(handles, routine, args, count, flags & THREAD_SUSPENDED);
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleThreadLatencyStats()
+{
+    TCB* volatile handle;
+    latency_stats_t* volatile stats;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outStats], a2" : [outStats] "=r" (stats));
 
+    auto returnValue = TCB::getLatencyStats(handle, stats);
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleThreadCacheLimit()
+{
+    uint64 volatile limit;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outLimit], a1" : [outLimit] "=r" (limit));
+
+    TCB::setThreadCacheLimit(limit);
+}
+
+void Kernel::handleThreadStackUsage()
+{
+    TCB* volatile handle;
+    size_t* volatile used;
+    size_t* volatile size;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outUsed], a2" : [outUsed] "=r" (used));
+    __asm__ volatile ("mv %[outSize], a3" : [outSize] "=r" (size));
+
+    // Null handle is the running thread
+    if(handle == nullptr) handle = TCB::running;
+    auto returnValue = TCB::allThreads.contains(handle) ? handle->getStackUsage(used, size) : -1;
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleThreadSetPriority()
+{
+    TCB* volatile handle;
+    int volatile priority;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outPriority], a2" : [outPriority] "=r" (priority));
+
+    auto returnValue = TCB::allThreads.contains(handle) ? TCB::setPriority(handle, priority) : -1;
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleRseqRegister()
+{
+    rseq_t* volatile area;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outArea], a1" : [outArea] "=r" (area));
+
+    TCB::running->m_Rseq = area;
+    auto returnValue = 0;
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleSemaphoreOpen()
+{
     SCB** volatile handle;
     unsigned volatile init;
+    uint64 volatile callSite;
 
-    // Get arguments
-    __asm__ volatile ("mv %[outHandle], a7" : [outHandle] "=r" (handle));
+    // Get arguments before alloc overwrites them
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
     __asm__ volatile ("mv %[outInit], a2" : [outInit] "=r" (init));
+    __asm__ volatile ("mv %[outCallSite], a3" : [outCallSite] "=r" (callSite));
 
-    *handle = new (newSCB) SCB(init);
+    auto newSCB = static_cast<SCB*>(MemoryAllocator::alloc(sizeof(SCB)));
+    if(newSCB != nullptr) new (newSCB) SCB(init);
+
+    if(newSCB != nullptr) newSCB->setCallSite(callSite);
+
+    *handle = newSCB;
 
     auto returnValue = (*handle == nullptr ? -1 : 0);
 
@@ -358,8 +589,7 @@ void Kernel::handleSemaphoreWait()
     // Get arguments
     __asm__ volatile ("mv %[outId], a7" : [outId] "=r" (id));
 
-    id->wait();
-    auto returnValue = 0;
+    auto returnValue = id->wait();
 
     // Store results in A0
     __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
@@ -375,8 +605,109 @@ void Kernel::handleSemaphoreSignal()
     // Get arguments
     __asm__ volatile ("mv %[outId], a7" : [outId] "=r" (id));
 
-    id->signal();
-    auto returnValue = 0;
+    auto returnValue = id->signal();
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleSemaphoreOpenFlags()
+{
+    SCB** volatile handle;
+    unsigned volatile init;
+    unsigned volatile flags;
+    uint64 volatile callSite;
+
+    // Get arguments before alloc overwrites them
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outInit], a2" : [outInit] "=r" (init));
+    __asm__ volatile ("mv %[outFlags], a3" : [outFlags] "=r" (flags));
+    __asm__ volatile ("mv %[outCallSite], a6" : [outCallSite] "=r" (callSite));
+
+    auto policy = SCB::WAKE_FIFO;
+    if(flags & SEM_LIFO) policy = SCB::WAKE_LIFO;
+    else if(flags & SEM_PRIORITY) policy = SCB::WAKE_PRIORITY;
+
+    auto newSCB = static_cast<SCB*>(MemoryAllocator::alloc(sizeof(SCB)));
+    if(newSCB != nullptr) new (newSCB) SCB(init, false, flags & SEM_HANDOFF, policy);
+
+    if(newSCB != nullptr) newSCB->setCallSite(callSite);
+
+    *handle = newSCB;
+    auto returnValue = (*handle == nullptr ? -1 : 0);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleSemaphoreTryWait()
+{
+    SCB* volatile id;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outId], a1" : [outId] "=r" (id));
+
+    auto returnValue = (id == nullptr ? -1 : id->tryWait());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleSemaphoreTimedWait()
+{
+    SCB* volatile id;
+    time_t volatile timeout;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outId], a1" : [outId] "=r" (id));
+    __asm__ volatile ("mv %[outTimeout], a2" : [outTimeout] "=r" (timeout));
+
+    auto returnValue = (id == nullptr ? -1 : id->timedWait(timeout * Timer::TICK_PERIOD));
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleSemaphoreSignalN()
+{
+    SCB* volatile id;
+    unsigned volatile count;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outId], a1" : [outId] "=r" (id));
+    __asm__ volatile ("mv %[outCount], a2" : [outCount] "=r" (count));
+
+    auto returnValue = (id != nullptr ? id->signal(count) : -1);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleSemaphoreWaitN()
+{
+    SCB* volatile id;
+    unsigned volatile count;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outId], a1" : [outId] "=r" (id));
+    __asm__ volatile ("mv %[outCount], a2" : [outCount] "=r" (count));
+
+    auto returnValue = (id == nullptr ? -1 : id->wait(count));
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleSemaphoreLockStats()
+{
+    lockstat_t* volatile stats;
+    int volatile count;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outStats], a1" : [outStats] "=r" (stats));
+    __asm__ volatile ("mv %[outCount], a2" : [outCount] "=r" (count));
+
+    auto returnValue = SCB::getLockStats(stats, count);
 
     // Store results in A0
     __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
@@ -389,28 +720,630 @@ void Kernel::handleTimeSleep()
     // Get arguments
     __asm__ volatile ("mv %[outTime], a1" : [outTime] "=r" (time));
 
-    auto returnValue = TCB::sleep(time);
+    auto returnValue = TCB::sleep(time * Timer::TICK_PERIOD);
 
     // Store results in A0
     __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
 }
 
-void Kernel::handleGetChar()
+void Kernel::handleTimeSleepNs()
 {
-    auto returnValue = getCharFromInputBuffer();
+    uint64 volatile nanoseconds;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outNanoseconds], a1" : [outNanoseconds] "=r" (nanoseconds));
+
+    auto returnValue = TCB::sleep(Timer::fromNanoseconds(nanoseconds));
 
     // Store results in A0
     __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
 }
 
-void Kernel::handlePutChar()
+void Kernel::handleTimeNowNs()
 {
-    char volatile outputChar;
+    auto volatile returnValue = Timer::toNanoseconds(Timer::now());
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleTimeNow()
+{
+    auto volatile returnValue = Timer::now() / Timer::TICK_PERIOD;
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleTimeSleepUntil()
+{
+    time_t volatile tick;
 
     // Get arguments
-    __asm__ volatile ("mv %[outChar], a1" : [outChar] "=r" (outputChar));
+    __asm__ volatile ("mv %[outTick], a1" : [outTick] "=r" (tick));
 
-    addCharToOutputBuffer(outputChar);
+    // Deadline that has already passed doesn't block
+    auto deadline = tick * Timer::TICK_PERIOD;
+    auto now = Timer::now();
+    auto returnValue = (deadline > now) ? TCB::sleep(deadline - now) : 0;
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleTimerCreate()
+{
+    KernelTimer** volatile handle;
+    KernelTimer::Callback volatile callback;
+    void* volatile args;
+    TCB* volatile dispatcher;
+
+    // Get arguments, dispatcher is passed in A6 because A4 and A5 don't survive the trap
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outCallback], a2" : [outCallback] "=r" (callback));
+    __asm__ volatile ("mv %[outArgs], a3" : [outArgs] "=r" (args));
+    __asm__ volatile ("mv %[outDispatcher], a6" : [outDispatcher] "=r" (dispatcher));
+
+    if(dispatcher != nullptr && !TCB::allThreads.contains(dispatcher)) *handle = nullptr;
+    else *handle = KernelTimer::createTimer(callback, args, dispatcher);
+
+    auto returnValue = (*handle == nullptr ? -1 : 0);
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleTimerArm()
+{
+    KernelTimer* volatile handle;
+    time_t volatile delay;
+    time_t volatile period;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outDelay], a2" : [outDelay] "=r" (delay));
+    __asm__ volatile ("mv %[outPeriod], a3" : [outPeriod] "=r" (period));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->arm(delay, period));
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleTimerCancel()
+{
+    KernelTimer* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->cancel());
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleTimerDelete()
+{
+    KernelTimer* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = KernelTimer::deleteTimer(handle);
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleTimerDispatch()
+{
+    KernelTimer::Callback* volatile callback;
+    void** volatile args;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outCallback], a1" : [outCallback] "=r" (callback));
+    __asm__ volatile ("mv %[outArgs], a2" : [outArgs] "=r" (args));
+
+    // Callback itself is called by the user wrapper in user mode, the timer can be rearmed or deleted from it
+    auto timer = KernelTimer::waitExpired();
+    *callback = timer->getCallback();
+    *args = timer->getArgs();
+
+    auto returnValue = 0;
+
+    // Store result in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleGetChar()
+{
+    auto returnValue = getCharFromInputBuffer();
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handlePutChar()
+{
+    char volatile outputChar;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outChar], a1" : [outChar] "=r" (outputChar));
+
+    addCharToOutputBuffer(outputChar);
+}
+
+void Kernel::handleFutexWait()
+{
+    uint32* volatile address;
+    uint32 volatile expected;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outAddress], a1" : [outAddress] "=r" (address));
+    __asm__ volatile ("mv %[outExpected], a2" : [outExpected] "=r" (expected));
+
+    auto returnValue = KernelFutex::wait(address, expected);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleFutexWake()
+{
+    uint32* volatile address;
+    int volatile count;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outAddress], a1" : [outAddress] "=r" (address));
+    __asm__ volatile ("mv %[outCount], a2" : [outCount] "=r" (count));
+
+    auto returnValue = KernelFutex::wake(address, count);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleWaitAny()
+{
+    wait_source_t* volatile sources;
+    int volatile count;
+    time_t volatile timeout;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outSources], a1" : [outSources] "=r" (sources));
+    __asm__ volatile ("mv %[outCount], a2" : [outCount] "=r" (count));
+    __asm__ volatile ("mv %[outTimeout], a3" : [outTimeout] "=r" (timeout));
+
+    auto returnValue = KernelWaitAny::waitAny(sources, count, timeout);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleMutexOpen()
+{
+    KernelMutex** volatile handle;
+
+    // Get arguments before alloc overwrites them
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    *handle = KernelMutex::createMutex();
+    auto returnValue = (*handle == nullptr ? -1 : 0);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleMutexClose()
+{
+    KernelMutex* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = KernelMutex::deleteMutex(handle);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleMutexLock()
+{
+    KernelMutex* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->lock());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleMutexTryLock()
+{
+    KernelMutex* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->tryLock());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleMutexUnlock()
+{
+    KernelMutex* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->unlock());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleConditionOpen()
+{
+    KernelCondition** volatile handle;
+
+    // Get arguments before alloc overwrites them
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    *handle = KernelCondition::createCondition();
+    auto returnValue = (*handle == nullptr ? -1 : 0);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleConditionWait()
+{
+    KernelCondition* volatile handle;
+    KernelMutex* volatile mutex;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outMutex], a2" : [outMutex] "=r" (mutex));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->wait(mutex));
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleConditionClose()
+{
+    KernelCondition* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = KernelCondition::deleteCondition(handle);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleConditionSignal()
+{
+    KernelCondition* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->signal());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleConditionBroadcast()
+{
+    KernelCondition* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->broadcast());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleRWLockOpen()
+{
+    KernelRWLock** volatile handle;
+    unsigned volatile flags;
+
+    // Get arguments before alloc overwrites them
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outFlags], a2" : [outFlags] "=r" (flags));
+
+    *handle = KernelRWLock::createRWLock(flags & RWLOCK_PREFER_WRITERS);
+    auto returnValue = (*handle == nullptr ? -1 : 0);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleRWLockClose()
+{
+    KernelRWLock* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = KernelRWLock::deleteRWLock(handle);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleRWLockReadLock()
+{
+    KernelRWLock* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->readLock());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleRWLockWriteLock()
+{
+    KernelRWLock* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->writeLock());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleRWLockUnlock()
+{
+    KernelRWLock* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->unlock());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleMailboxOpen()
+{
+    KernelMailbox** volatile handle;
+    size_t volatile messageSize;
+    size_t volatile capacity;
+
+    // Get arguments before alloc overwrites them
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outMessageSize], a2" : [outMessageSize] "=r" (messageSize));
+    __asm__ volatile ("mv %[outCapacity], a3" : [outCapacity] "=r" (capacity));
+
+    *handle = KernelMailbox::createMailbox(messageSize, capacity);
+    auto returnValue = (*handle == nullptr ? -1 : 0);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleMailboxClose()
+{
+    KernelMailbox* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = KernelMailbox::deleteMailbox(handle);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleMailboxSend()
+{
+    KernelMailbox* volatile handle;
+    const void* volatile message;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outMessage], a2" : [outMessage] "=r" (message));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->send(message));
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleMailboxReceive()
+{
+    KernelMailbox* volatile handle;
+    void* volatile message;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outMessage], a2" : [outMessage] "=r" (message));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->receive(message));
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handlePipeCreate()
+{
+    KernelPipe** volatile handle;
+    size_t volatile capacity;
+
+    // Get arguments before alloc overwrites them
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outCapacity], a2" : [outCapacity] "=r" (capacity));
+
+    *handle = KernelPipe::createPipe(capacity);
+    auto returnValue = (*handle == nullptr ? -1 : 0);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handlePipeDelete()
+{
+    KernelPipe* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = KernelPipe::deletePipe(handle);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handlePipeRead()
+{
+    KernelPipe* volatile handle;
+    void* volatile buffer;
+    size_t volatile size;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outBuffer], a2" : [outBuffer] "=r" (buffer));
+    __asm__ volatile ("mv %[outSize], a3" : [outSize] "=r" (size));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->read(buffer, size));
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handlePipeWrite()
+{
+    KernelPipe* volatile handle;
+    const void* volatile buffer;
+    size_t volatile size;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outBuffer], a2" : [outBuffer] "=r" (buffer));
+    __asm__ volatile ("mv %[outSize], a3" : [outSize] "=r" (size));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->write(buffer, size));
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleBarrierOpen()
+{
+    KernelBarrier** volatile handle;
+    unsigned volatile parties;
+
+    // Get arguments before alloc overwrites them
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outParties], a2" : [outParties] "=r" (parties));
+
+    *handle = KernelBarrier::createBarrier(parties);
+    auto returnValue = (*handle == nullptr ? -1 : 0);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleBarrierClose()
+{
+    KernelBarrier* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = KernelBarrier::deleteBarrier(handle);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleBarrierWait()
+{
+    KernelBarrier* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->wait());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleLatchOpen()
+{
+    KernelLatch** volatile handle;
+    unsigned volatile count;
+
+    // Get arguments before alloc overwrites them
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outCount], a2" : [outCount] "=r" (count));
+
+    *handle = KernelLatch::createLatch(count);
+    auto returnValue = (*handle == nullptr ? -1 : 0);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleLatchClose()
+{
+    KernelLatch* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = KernelLatch::deleteLatch(handle);
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleLatchCountDown()
+{
+    KernelLatch* volatile handle;
+    unsigned volatile count;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+    __asm__ volatile ("mv %[outCount], a2" : [outCount] "=r" (count));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->countDown(count));
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
+}
+
+void Kernel::handleLatchWait()
+{
+    KernelLatch* volatile handle;
+
+    // Get arguments
+    __asm__ volatile ("mv %[outHandle], a1" : [outHandle] "=r" (handle));
+
+    auto returnValue = (handle == nullptr ? -1 : handle->wait());
+
+    // Store results in A0
+    __asm__ volatile ("mv a0, %[inReturnValue]" : : [inReturnValue] "r" (returnValue));
 }
 
 char Kernel::getCharFromInputBuffer()
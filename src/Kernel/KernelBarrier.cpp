@@ -0,0 +1,41 @@
+#include "../../h/Kernel/KernelBarrier.hpp"
+#include "../../h/Kernel/TCB.hpp"
+
+KernelBarrier::KernelBarrier(unsigned parties)
+    :
+    m_Parties(parties),
+    m_Arrived(0)
+{
+}
+
+KernelBarrier* KernelBarrier::createBarrier(unsigned parties)
+{
+    if(parties == 0) return nullptr;
+
+    auto newBarrier = static_cast<KernelBarrier*>(MemoryAllocator::alloc(sizeof(KernelBarrier)));
+    if(newBarrier != nullptr) new (newBarrier) KernelBarrier(parties);
+
+    return newBarrier;
+}
+
+int KernelBarrier::deleteBarrier(KernelBarrier* handle)
+{
+    if(handle == nullptr) return -1;
+
+    // Threads that are still waiting find out that the barrier is gone
+    while(!handle->m_Waiters.isEmpty()) handle->m_Waiters.first()->thread->wake(-1);
+
+    handle->~KernelBarrier();
+    return MemoryAllocator::free(handle);
+}
+
+int KernelBarrier::wait()
+{
+    if(++m_Arrived < m_Parties) return TCB::block(&m_Waiters);
+
+    // Released threads are out of the queue before anyone can arrive for the next phase
+    m_Arrived = 0;
+    while(!m_Waiters.isEmpty()) m_Waiters.first()->thread->wake(0);
+
+    return BARRIER_SERIAL_THREAD;
+}
@@ -0,0 +1,50 @@
+#include "../../h/Kernel/KernelCondition.hpp"
+#include "../../h/Kernel/KernelMutex.hpp"
+#include "../../h/Kernel/TCB.hpp"
+
+KernelCondition* KernelCondition::createCondition()
+{
+    auto newCondition = static_cast<KernelCondition*>(MemoryAllocator::alloc(sizeof(KernelCondition)));
+    if(newCondition != nullptr) new (newCondition) KernelCondition();
+
+    return newCondition;
+}
+
+int KernelCondition::deleteCondition(KernelCondition* handle)
+{
+    if(handle == nullptr) return -1;
+
+    // Threads that are still waiting find out that the condition is gone
+    while(!handle->m_Waiters.isEmpty()) handle->m_Waiters.first()->thread->wake(-1);
+
+    handle->~KernelCondition();
+    return MemoryAllocator::free(handle);
+}
+
+int KernelCondition::wait(KernelMutex* mutex)
+{
+    if(mutex == nullptr || mutex->getOwner() != TCB::running) return -1;
+
+    // System calls run with interrupts disabled, so no signal can come between unlocking and blocking
+    mutex->unlock();
+    return TCB::block(&m_Waiters, mutex);
+}
+
+int KernelCondition::signal()
+{
+    auto node = m_Waiters.first();
+    if(node != nullptr) ((KernelMutex*)node->key)->acquireFor(node);
+
+    return 0;
+}
+
+int KernelCondition::broadcast()
+{
+    while(!m_Waiters.isEmpty())
+    {
+        auto node = m_Waiters.first();
+        ((KernelMutex*)node->key)->acquireFor(node);
+    }
+
+    return 0;
+}
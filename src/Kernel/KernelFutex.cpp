@@ -0,0 +1,45 @@
+#include "../../h/Kernel/KernelFutex.hpp"
+#include "../../h/Kernel/TCB.hpp"
+
+WaitQueue KernelFutex::queues[QUEUE_COUNT];
+
+int KernelFutex::wait(uint32* address, uint32 expected)
+{
+    if(address == nullptr) return -1;
+
+    // System calls run with interrupts disabled, so no wake can come between the check and blocking
+    if(*((uint32 volatile*)address) != expected) return FUTEX_CHANGED;
+
+    return TCB::block(queueFor(address), address);
+}
+
+int KernelFutex::wake(uint32* address, int count)
+{
+    if(address == nullptr) return -1;
+
+    auto queue = queueFor(address);
+
+    auto woken = 0;
+    auto node = queue->first();
+    while(node != nullptr && woken < count)
+    {
+        auto next = node->next;
+
+        // Other addresses can share the queue
+        if(node->key == address)
+        {
+            node->thread->wake(0);
+            woken++;
+        }
+
+        node = next;
+    }
+
+    return woken;
+}
+
+WaitQueue* KernelFutex::queueFor(const uint32* address)
+{
+    auto word = (uint64)address >> 2;
+    return &queues[(word ^ (word >> 6)) % QUEUE_COUNT];
+}
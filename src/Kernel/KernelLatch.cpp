@@ -0,0 +1,47 @@
+#include "../../h/Kernel/KernelLatch.hpp"
+#include "../../h/Kernel/TCB.hpp"
+
+KernelLatch::KernelLatch(unsigned count)
+    :
+    m_Count(count)
+{
+}
+
+KernelLatch* KernelLatch::createLatch(unsigned count)
+{
+    auto newLatch = static_cast<KernelLatch*>(MemoryAllocator::alloc(sizeof(KernelLatch)));
+    if(newLatch != nullptr) new (newLatch) KernelLatch(count);
+
+    return newLatch;
+}
+
+int KernelLatch::deleteLatch(KernelLatch* handle)
+{
+    if(handle == nullptr) return -1;
+
+    // Threads that are still waiting find out that the latch is gone
+    while(!handle->m_Waiters.isEmpty()) handle->m_Waiters.first()->thread->wake(-1);
+
+    handle->~KernelLatch();
+    return MemoryAllocator::free(handle);
+}
+
+int KernelLatch::countDown(unsigned count)
+{
+    if(m_Count == 0) return 0;
+
+    m_Count = (count < m_Count ? m_Count - count : 0);
+    if(m_Count == 0)
+    {
+        while(!m_Waiters.isEmpty()) m_Waiters.first()->thread->wake(0);
+    }
+
+    return 0;
+}
+
+int KernelLatch::wait()
+{
+    if(m_Count == 0) return 0;
+
+    return TCB::block(&m_Waiters);
+}
@@ -0,0 +1,105 @@
+#include "../../h/Kernel/KernelMailbox.hpp"
+#include "../../h/Kernel/TCB.hpp"
+
+KernelMailbox::KernelMailbox(size_t messageSize, size_t capacity, char* ring)
+    :
+    m_MessageSize(messageSize),
+    m_Capacity(capacity),
+    m_Ring(ring),
+    m_Head(0),
+    m_Count(0)
+{
+}
+
+KernelMailbox* KernelMailbox::createMailbox(size_t messageSize, size_t capacity)
+{
+    if(messageSize == 0) return nullptr;
+
+    auto newMailbox = static_cast<KernelMailbox*>(MemoryAllocator::alloc(sizeof(KernelMailbox) + messageSize * capacity));
+    if(newMailbox != nullptr) new (newMailbox) KernelMailbox(messageSize, capacity, (char*)(newMailbox + 1));
+
+    return newMailbox;
+}
+
+int KernelMailbox::deleteMailbox(KernelMailbox* handle)
+{
+    if(handle == nullptr) return -1;
+
+    // Threads that are still waiting find out that the mailbox is gone
+    while(!handle->m_Receivers.isEmpty()) handle->m_Receivers.first()->thread->wake(-1);
+    while(!handle->m_Senders.isEmpty()) handle->m_Senders.first()->thread->wake(-1);
+
+    handle->~KernelMailbox();
+    return MemoryAllocator::free(handle);
+}
+
+int KernelMailbox::send(const void* message)
+{
+    if(message == nullptr) return -1;
+
+    auto receiver = m_Receivers.first();
+    if(receiver != nullptr)
+    {
+        copy((void*)receiver->key, message);
+
+        // Receiver runs next unless that would put it ahead of a more important sender,
+        // so a message hop costs one trap on each side
+        auto thread = receiver->thread;
+        auto directed = thread->getPriority() >= TCB::running->getPriority();
+        thread->wake(0);
+        if(directed) TCB::yieldTo(thread);
+
+        return 0;
+    }
+
+    if(m_Count < m_Capacity)
+    {
+        copy(slot(m_Head + m_Count), message);
+        m_Count++;
+        return 0;
+    }
+
+    return TCB::block(&m_Senders, message);
+}
+
+int KernelMailbox::receive(void* message)
+{
+    if(message == nullptr) return -1;
+
+    auto sender = m_Senders.first();
+
+    if(m_Count > 0)
+    {
+        copy(message, slot(m_Head));
+        m_Head = (m_Head + 1) % m_Capacity;
+        m_Count--;
+
+        // Freed slot goes to the sender that waited the longest
+        if(sender != nullptr)
+        {
+            copy(slot(m_Head + m_Count), sender->key);
+            m_Count++;
+            sender->thread->wake(0);
+        }
+
+        return 0;
+    }
+
+    // Mailbox without capacity keeps senders waiting until a receiver takes their message
+    if(sender != nullptr)
+    {
+        copy(message, sender->key);
+        sender->thread->wake(0);
+        return 0;
+    }
+
+    return TCB::block(&m_Receivers, message);
+}
+
+void KernelMailbox::copy(void* destination, const void* source) const
+{
+    auto to = (char*)destination;
+    auto from = (const char*)source;
+
+    for(size_t i = 0; i < m_MessageSize; i++) to[i] = from[i];
+}
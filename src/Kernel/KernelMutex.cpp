@@ -0,0 +1,190 @@
+#include "../../h/Kernel/KernelMutex.hpp"
+#include "../../h/Kernel/TCB.hpp"
+
+KernelMutex::KernelMutex()
+    :
+    m_Owner(nullptr),
+    m_NextHeld(nullptr)
+{
+}
+
+KernelMutex* KernelMutex::createMutex()
+{
+    auto newMutex = static_cast<KernelMutex*>(MemoryAllocator::alloc(sizeof(KernelMutex)));
+    if(newMutex != nullptr) new (newMutex) KernelMutex();
+
+    return newMutex;
+}
+
+int KernelMutex::deleteMutex(KernelMutex* handle)
+{
+    if(handle == nullptr) return -1;
+
+    // Threads that are still waiting find out that the mutex is gone
+    while(!handle->m_Waiters.isEmpty())
+    {
+        auto thread = handle->m_Waiters.first()->thread;
+        thread->m_BlockedOnMutex = nullptr;
+        thread->wake(-1);
+    }
+
+    if(handle->m_Owner != nullptr)
+    {
+        auto owner = handle->m_Owner;
+        handle->release();
+        updatePriority(owner);
+    }
+
+    handle->~KernelMutex();
+    return MemoryAllocator::free(handle);
+}
+
+int KernelMutex::lock()
+{
+    auto thread = TCB::running;
+
+    if(m_Owner == nullptr)
+    {
+        giveTo(thread);
+        return 0;
+    }
+
+    // Not recursive, the owner would wait for itself
+    if(m_Owner == thread) return -1;
+
+    thread->m_BlockedOnMutex = this;
+    inheritPriority(thread->m_Priority);
+
+    // Unlock hands the mutex over before waking the thread up
+    return TCB::block(&m_Waiters, this);
+}
+
+int KernelMutex::tryLock()
+{
+    if(m_Owner != nullptr) return MUTEX_BUSY;
+
+    giveTo(TCB::running);
+    return 0;
+}
+
+int KernelMutex::unlock()
+{
+    auto owner = TCB::running;
+    if(m_Owner != owner) return -1;
+
+    // Next owner is chosen before the old one drops its inherited priority
+    handOver();
+    updatePriority(owner);
+
+    return 0;
+}
+
+void KernelMutex::releaseAll(TCB* thread)
+{
+    while(thread->m_HeldMutexes != nullptr) thread->m_HeldMutexes->handOver();
+}
+
+void KernelMutex::acquireFor(WaitQueue::Node* node)
+{
+    auto thread = node->thread;
+
+    if(m_Owner == nullptr)
+    {
+        giveTo(thread);
+        thread->wake(0);
+        return;
+    }
+
+    // Same node moves to the queue of the mutex, the thread stays blocked
+    node->queue->remove(node);
+    node->key = this;
+    m_Waiters.addLast(node);
+
+    thread->m_BlockedOnMutex = this;
+    inheritPriority(thread->m_Priority);
+}
+
+void KernelMutex::inheritPriority(int priority)
+{
+    for(auto owner = m_Owner; owner != nullptr && owner->m_Priority < priority;)
+    {
+        owner->setEffectivePriority(priority);
+        owner = (owner->m_BlockedOnMutex != nullptr ? owner->m_BlockedOnMutex->m_Owner : nullptr);
+    }
+}
+
+void KernelMutex::updatePriority(TCB* thread)
+{
+    while(thread != nullptr)
+    {
+        auto priority = thread->m_BasePriority;
+        for(auto mutex = thread->m_HeldMutexes; mutex != nullptr; mutex = mutex->m_NextHeld)
+        {
+            auto ceiling = mutex->ceilingPriority();
+            if(ceiling > priority) priority = ceiling;
+        }
+
+        if(priority == thread->m_Priority) return;
+        thread->setEffectivePriority(priority);
+
+        // Owner of the mutex the thread waits for might have inherited the old priority
+        thread = (thread->m_BlockedOnMutex != nullptr ? thread->m_BlockedOnMutex->m_Owner : nullptr);
+    }
+}
+
+WaitQueue::Node* KernelMutex::highestWaiter() const
+{
+    WaitQueue::Node* highest = nullptr;
+    for(auto node = m_Waiters.first(); node != nullptr; node = node->next)
+    {
+        if(highest == nullptr || node->thread->m_Priority > highest->thread->m_Priority) highest = node;
+    }
+
+    return highest;
+}
+
+int KernelMutex::ceilingPriority() const
+{
+    auto highest = highestWaiter();
+    return highest != nullptr ? highest->thread->m_Priority : THREAD_PRIORITY_MIN;
+}
+
+void KernelMutex::giveTo(TCB* thread)
+{
+    m_Owner = thread;
+    m_NextHeld = thread->m_HeldMutexes;
+    thread->m_HeldMutexes = this;
+}
+
+void KernelMutex::handOver()
+{
+    release();
+
+    auto next = highestWaiter();
+    if(next == nullptr) return;
+
+    auto thread = next->thread;
+    thread->m_BlockedOnMutex = nullptr;
+    giveTo(thread);
+    thread->wake(0);
+    updatePriority(thread);
+}
+
+void KernelMutex::release()
+{
+    auto owner = m_Owner;
+
+    KernelMutex* prev = nullptr;
+    auto cur = owner->m_HeldMutexes;
+    while(cur != this)
+    {
+        prev = cur;
+        cur = cur->m_NextHeld;
+    }
+
+    if(prev != nullptr) prev->m_NextHeld = m_NextHeld;
+    else owner->m_HeldMutexes = m_NextHeld;
+
+    m_Owner = nullptr;
+    m_NextHeld = nullptr;
+}
@@ -0,0 +1,83 @@
+#include "../../h/Kernel/KernelPipe.hpp"
+#include "../../h/Kernel/TCB.hpp"
+
+KernelPipe::KernelPipe(size_t capacity, char* ring)
+    :
+    m_Capacity(capacity),
+    m_Ring(ring),
+    m_Head(0),
+    m_Count(0)
+{
+}
+
+KernelPipe* KernelPipe::createPipe(size_t capacity)
+{
+    if(capacity == 0) return nullptr;
+
+    auto newPipe = static_cast<KernelPipe*>(MemoryAllocator::alloc(sizeof(KernelPipe) + capacity));
+    if(newPipe != nullptr) new (newPipe) KernelPipe(capacity, (char*)(newPipe + 1));
+
+    return newPipe;
+}
+
+int KernelPipe::deletePipe(KernelPipe* handle)
+{
+    if(handle == nullptr) return -1;
+
+    // Threads that are still waiting find out that the pipe is gone
+    while(!handle->m_Readers.isEmpty()) handle->m_Readers.first()->thread->wake(-1);
+    while(!handle->m_Writers.isEmpty()) handle->m_Writers.first()->thread->wake(-1);
+
+    handle->~KernelPipe();
+    return MemoryAllocator::free(handle);
+}
+
+int KernelPipe::read(void* buffer, size_t size)
+{
+    if(buffer == nullptr) return -1;
+    if(size == 0) return 0;
+
+    // Another reader can empty the pipe before a woken reader gets to run
+    while(m_Count == 0)
+    {
+        auto status = TCB::block(&m_Readers);
+        if(status != 0) return status;
+    }
+
+    auto to = (char*)buffer;
+    auto moved = (size < m_Count ? size : m_Count);
+    for(size_t i = 0; i < moved; i++) to[i] = m_Ring[(m_Head + i) % m_Capacity];
+
+    m_Head = (m_Head + moved) % m_Capacity;
+    m_Count -= moved;
+
+    // Whoever is woken up passes the wakeup on if something is left for the next one
+    if(!m_Writers.isEmpty()) m_Writers.first()->thread->wake(0);
+    if(m_Count > 0 && !m_Readers.isEmpty()) m_Readers.first()->thread->wake(0);
+
+    return (int)moved;
+}
+
+int KernelPipe::write(const void* buffer, size_t size)
+{
+    if(buffer == nullptr) return -1;
+    if(size == 0) return 0;
+
+    while(m_Count == m_Capacity)
+    {
+        auto status = TCB::block(&m_Writers);
+        if(status != 0) return status;
+    }
+
+    auto from = (const char*)buffer;
+    auto space = m_Capacity - m_Count;
+    auto moved = (size < space ? size : space);
+    for(size_t i = 0; i < moved; i++) m_Ring[(m_Head + m_Count + i) % m_Capacity] = from[i];
+
+    m_Count += moved;
+
+    if(!m_Readers.isEmpty()) m_Readers.first()->thread->wake(0);
+    if(m_Count < m_Capacity && !m_Writers.isEmpty()) m_Writers.first()->thread->wake(0);
+
+    return (int)moved;
+}
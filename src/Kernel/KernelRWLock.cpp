@@ -0,0 +1,105 @@
+#include "../../h/Kernel/KernelRWLock.hpp"
+#include "../../h/Kernel/TCB.hpp"
+
+KernelRWLock::KernelRWLock(bool preferWriters)
+    :
+    m_Readers(0),
+    m_Writer(nullptr),
+    m_PreferWriters(preferWriters)
+{
+}
+
+KernelRWLock* KernelRWLock::createRWLock(bool preferWriters)
+{
+    auto newLock = static_cast<KernelRWLock*>(MemoryAllocator::alloc(sizeof(KernelRWLock)));
+    if(newLock != nullptr) new (newLock) KernelRWLock(preferWriters);
+
+    return newLock;
+}
+
+int KernelRWLock::deleteRWLock(KernelRWLock* handle)
+{
+    if(handle == nullptr) return -1;
+
+    // Threads that are still waiting find out that the lock is gone
+    while(!handle->m_WaitingReaders.isEmpty()) handle->m_WaitingReaders.first()->thread->wake(-1);
+    while(!handle->m_WaitingWriters.isEmpty()) handle->m_WaitingWriters.first()->thread->wake(-1);
+
+    handle->~KernelRWLock();
+    return MemoryAllocator::free(handle);
+}
+
+int KernelRWLock::readLock()
+{
+    if(m_Writer == TCB::running) return -1;
+
+    auto thread = TCB::running;
+
+    // Without a writer readers just enter, waiting writers only hold them back with writer preference.
+    // A thread that already reads isn't held back, the writer might be waiting for it to leave
+    if(m_Writer == nullptr && !(m_PreferWriters && !m_WaitingWriters.isEmpty() && thread->m_ReadLocks == 0))
+    {
+        m_Readers++;
+        thread->m_ReadLocks++;
+        return 0;
+    }
+
+    // Whoever admits the reader counts it
+    return TCB::block(&m_WaitingReaders, this);
+}
+
+int KernelRWLock::writeLock()
+{
+    if(m_Writer == TCB::running) return -1;
+
+    if(m_Writer == nullptr && m_Readers == 0)
+    {
+        m_Writer = TCB::running;
+        return 0;
+    }
+
+    // Whoever hands the lock over makes the thread the writer
+    return TCB::block(&m_WaitingWriters, this);
+}
+
+int KernelRWLock::unlock()
+{
+    if(m_Writer == TCB::running)
+    {
+        m_Writer = nullptr;
+
+        // Readers that waited for this writer go first, all of them at once
+        if(!m_WaitingReaders.isEmpty()) admitReaders();
+        else if(!m_WaitingWriters.isEmpty())
+        {
+            m_Writer = m_WaitingWriters.first()->thread;
+            m_Writer->wake(0);
+        }
+
+        return 0;
+    }
+
+    // Read locks aren't told apart per lock, a thread that reads some lock can release a read lock of any
+    if(m_Readers == 0 || TCB::running->m_ReadLocks == 0) return -1;
+    TCB::running->m_ReadLocks--;
+
+    // Last reader out lets the next writer in
+    if(--m_Readers == 0 && !m_WaitingWriters.isEmpty())
+    {
+        m_Writer = m_WaitingWriters.first()->thread;
+        m_Writer->wake(0);
+    }
+
+    return 0;
+}
+
+void KernelRWLock::admitReaders()
+{
+    while(!m_WaitingReaders.isEmpty())
+    {
+        auto thread = m_WaitingReaders.first()->thread;
+        m_Readers++;
+        thread->m_ReadLocks++;
+        thread->wake(0);
+    }
+}
@@ -0,0 +1,212 @@
+#include "../../h/Kernel/KernelTimer.hpp"
+#include "../../h/Kernel/TCB.hpp"
+#include "../../h/Kernel/Kernel.hpp"
+#include "../../h/Kernel/Timer.hpp"
+
+TCB* KernelTimer::sharedDispatcher = nullptr;
+
+KernelTimer::KernelTimer(Callback callback, void* args, TCB* dispatcher)
+    :
+    m_Callback(callback),
+    m_Args(args),
+    m_Dispatcher(nullptr),
+    m_NextDispatched(nullptr),
+    m_Entry(&expired, this),
+    m_Expiry(0),
+    m_Period(0),
+    m_Pending(false),
+    m_NextPending(nullptr)
+{
+    if(dispatcher != nullptr) attach(dispatcher);
+}
+
+KernelTimer* KernelTimer::createTimer(Callback callback, void* args, TCB* dispatcher)
+{
+    // Shared dispatcher is only created once some timer needs it, callbacks are user code that makes
+    // system calls, so it runs in user mode like any other thread
+    if(callback != nullptr && dispatcher == nullptr)
+    {
+        dispatcher = getSharedDispatcher();
+        if(dispatcher == nullptr) return nullptr;
+    }
+
+    auto newTimer = static_cast<KernelTimer*>(MemoryAllocator::alloc(sizeof(KernelTimer)));
+    if(newTimer != nullptr) new (newTimer) KernelTimer(callback, args, dispatcher);
+
+    return newTimer;
+}
+
+int KernelTimer::deleteTimer(KernelTimer* handle)
+{
+    if(handle == nullptr) return -1;
+
+    // Threads that are still waiting find out that the timer is gone
+    while(!handle->m_Waiters.isEmpty()) handle->m_Waiters.first()->thread->wake(-1);
+
+    handle->cancel();
+    if(handle->m_Dispatcher != nullptr) handle->detach();
+
+    return MemoryAllocator::free(handle);
+}
+
+int KernelTimer::arm(uint64 delay, uint64 period)
+{
+    // Rearming drops an expiry that hasn't been dispatched yet
+    unqueue();
+
+    m_Period = period * Timer::TICK_PERIOD;
+    m_Expiry = Timer::now() + delay * Timer::TICK_PERIOD;
+    TimerQueue::insert(&m_Entry, delay * Timer::TICK_PERIOD);
+
+    return 0;
+}
+
+int KernelTimer::cancel()
+{
+    TimerQueue::remove(&m_Entry);
+    unqueue();
+
+    return 0;
+}
+
+void KernelTimer::expired(TimerQueue::Entry* entry)
+{
+    auto timer = static_cast<KernelTimer*>(entry->owner);
+
+    if(timer->m_Period != 0)
+    {
+        // Periods that were missed are skipped, their callbacks would be merged anyway
+        auto now = Timer::now();
+        do timer->m_Expiry += timer->m_Period; while(timer->m_Expiry <= now);
+
+        TimerQueue::insert(entry, timer->m_Expiry - now);
+    }
+
+    while(!timer->m_Waiters.isEmpty())
+    {
+        auto node = timer->m_Waiters.first();
+        node->thread->wake(0, false, node->index);
+    }
+
+    if(timer->m_Callback != nullptr) timer->queue();
+}
+
+void KernelTimer::queue()
+{
+    if(m_Pending) return;
+
+    m_Pending = true;
+    m_NextPending = nullptr;
+
+    if(m_Dispatcher->m_ExpiredTimersTail != nullptr) m_Dispatcher->m_ExpiredTimersTail->m_NextPending = this;
+    else m_Dispatcher->m_ExpiredTimers = this;
+    m_Dispatcher->m_ExpiredTimersTail = this;
+
+    if(m_Dispatcher->m_WaitingForTimers)
+    {
+        m_Dispatcher->m_WaitingForTimers = false;
+        m_Dispatcher->markWakeup();
+        Scheduler::put(m_Dispatcher);
+    }
+}
+
+void KernelTimer::unqueue()
+{
+    if(!m_Pending) return;
+
+    KernelTimer* prev = nullptr;
+    auto cur = m_Dispatcher->m_ExpiredTimers;
+    while(cur != this)
+    {
+        prev = cur;
+        cur = cur->m_NextPending;
+    }
+
+    if(prev != nullptr) prev->m_NextPending = m_NextPending;
+    else m_Dispatcher->m_ExpiredTimers = m_NextPending;
+    if(m_Dispatcher->m_ExpiredTimersTail == this) m_Dispatcher->m_ExpiredTimersTail = prev;
+
+    m_Pending = false;
+    m_NextPending = nullptr;
+}
+
+void KernelTimer::attach(TCB* dispatcher)
+{
+    m_Dispatcher = dispatcher;
+    m_NextDispatched = dispatcher->m_Timers;
+    dispatcher->m_Timers = this;
+}
+
+void KernelTimer::detach()
+{
+    KernelTimer* prev = nullptr;
+    auto cur = m_Dispatcher->m_Timers;
+    while(cur != this)
+    {
+        prev = cur;
+        cur = cur->m_NextDispatched;
+    }
+
+    if(prev != nullptr) prev->m_NextDispatched = m_NextDispatched;
+    else m_Dispatcher->m_Timers = m_NextDispatched;
+
+    m_Dispatcher = nullptr;
+    m_NextDispatched = nullptr;
+}
+
+void KernelTimer::detachDispatcher(TCB* thread)
+{
+    while(thread->m_Timers != nullptr)
+    {
+        auto timer = thread->m_Timers;
+        auto pending = timer->m_Pending;
+
+        timer->unqueue();
+        timer->detach();
+
+        auto dispatcher = getSharedDispatcher();
+        if(dispatcher == nullptr)
+        {
+            timer->m_Callback = nullptr;
+            continue;
+        }
+
+        timer->attach(dispatcher);
+        if(pending) timer->queue();
+    }
+}
+
+TCB* KernelTimer::getSharedDispatcher()
+{
+    if(sharedDispatcher == nullptr) sharedDispatcher = TCB::createThread(dispatcherThreadBody, nullptr, nullptr);
+    return sharedDispatcher;
+}
+
+KernelTimer* KernelTimer::waitExpired()
+{
+    auto thread = TCB::running;
+
+    // Timers expire from the timer interrupt, so the list is only looked at with interrupts disabled
+    Kernel::lock();
+    while(thread->m_ExpiredTimers == nullptr)
+    {
+        thread->m_WaitingForTimers = true;
+        thread->m_PutInScheduler = false;
+        TCB::yield();
+        Kernel::lock();
+    }
+
+    auto timer = thread->m_ExpiredTimers;
+    thread->m_ExpiredTimers = timer->m_NextPending;
+    if(thread->m_ExpiredTimers == nullptr) thread->m_ExpiredTimersTail = nullptr;
+
+    timer->m_Pending = false;
+    timer->m_NextPending = nullptr;
+
+    return timer;
+}
+
+[[noreturn]] void KernelTimer::dispatcherThreadBody(void*)
+{
+    while(true) timer_dispatch();
+}
@@ -0,0 +1,80 @@
+#include "../../h/Kernel/KernelWaitAny.hpp"
+#include "../../h/Kernel/Kernel.hpp"
+#include "../../h/Kernel/KernelTimer.hpp"
+#include "../../h/Kernel/MemoryAllocator.hpp"
+#include "../../h/Kernel/SCB.hpp"
+#include "../../h/Kernel/TCB.hpp"
+#include "../../h/Kernel/Timer.hpp"
+
+int KernelWaitAny::waitAny(wait_source_t* sources, int count, time_t timeout)
+{
+    if(sources == nullptr || count <= 0 || count > MAX_SOURCES) return -1;
+
+    for(auto i = 0; i < count; i++)
+    {
+        if(sources[i].handle == nullptr || queueOf(sources[i]) == nullptr) return -1;
+    }
+
+    auto ready = findReady(sources, count);
+    if(ready >= 0) return ready;
+
+    if(timeout == 0) return WAIT_TIMEOUT;
+
+    // Nodes can't live on the stack of the waiting thread, user stacks aren't sized for them
+    auto nodes = static_cast<WaitQueue::Node*>(MemoryAllocator::alloc(count * sizeof(WaitQueue::Node)));
+    if(nodes == nullptr) return -1;
+
+    for(auto i = 0; i < count; i++)
+    {
+        new (&nodes[i]) WaitQueue::Node(TCB::running, sources[i].handle, i);
+        if(i > 0) nodes[i - 1].sibling = &nodes[i];
+
+        queueOf(sources[i])->addLast(&nodes[i]);
+    }
+
+    auto status = TCB::blockQueued(nodes, timeout == WAIT_FOREVER ? 0 : timeout * Timer::TICK_PERIOD);
+    auto index = TCB::running->m_WakeIndex;
+
+    MemoryAllocator::free(nodes);
+
+    if(status == 0) return index;
+    if(status == SEM_TIMEOUT) return WAIT_TIMEOUT;
+    return -1;
+}
+
+int KernelWaitAny::findReady(wait_source_t* sources, int count)
+{
+    for(auto i = 0; i < count; i++)
+    {
+        switch(sources[i].type)
+        {
+        case WAIT_SEMAPHORE:
+            if(static_cast<SCB*>(sources[i].handle)->tryWait() == 0) return i;
+            break;
+        case WAIT_CONSOLE_INPUT:
+            // Characters are left in the queue, the thread reads them with getc
+            if(!Kernel::inputQueue.isEmpty()) return i;
+            break;
+        default:
+            // Timers only fire on expiries that happen while the thread waits
+            break;
+        }
+    }
+
+    return -1;
+}
+
+WaitQueue* KernelWaitAny::queueOf(const wait_source_t& source)
+{
+    switch(source.type)
+    {
+    case WAIT_SEMAPHORE:
+        return &static_cast<SCB*>(source.handle)->m_BlockedQueue;
+    case WAIT_CONSOLE_INPUT:
+        return &Kernel::inputWaiters;
+    case WAIT_TIMER:
+        return &static_cast<KernelTimer*>(source.handle)->m_Waiters;
+    default:
+        return nullptr;
+    }
+}
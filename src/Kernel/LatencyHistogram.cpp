@@ -0,0 +1,52 @@
+#include "../../h/Kernel/LatencyHistogram.hpp"
+
+LatencyHistogram::LatencyHistogram()
+    :
+    m_Samples(0),
+    m_Total(0),
+    m_Max(0),
+    m_Buckets()
+{
+}
+
+void LatencyHistogram::record(uint64 latency)
+{
+    auto bucket = 0;
+    for(auto value = latency; value > 1 && bucket < (int)LATENCY_BUCKETS - 1; value >>= 1) bucket++;
+
+    m_Buckets[bucket]++;
+    m_Samples++;
+    m_Total += latency;
+    if(latency > m_Max) m_Max = latency;
+}
+
+void LatencyHistogram::getStats(latency_stats_t* stats) const
+{
+    stats->samples = m_Samples;
+    stats->max = m_Max;
+    stats->average = (m_Samples == 0 ? 0 : m_Total / m_Samples);
+    stats->p50 = percentile(50);
+    stats->p90 = percentile(90);
+    stats->p99 = percentile(99);
+
+    for(size_t i = 0; i < LATENCY_BUCKETS; i++) stats->buckets[i] = m_Buckets[i];
+}
+
+uint64 LatencyHistogram::percentile(uint64 percent) const
+{
+    if(m_Samples == 0) return 0;
+
+    // Report the upper bound of the bucket the percentile falls in, the max is exact
+    auto needed = (m_Samples * percent + 99) / 100;
+    uint64 seen = 0;
+    for(size_t i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        seen += m_Buckets[i];
+        if(seen < needed) continue;
+
+        auto upperBound = (2UL << i) - 1;
+        return (upperBound < m_Max ? upperBound : m_Max);
+    }
+
+    return m_Max;
+}
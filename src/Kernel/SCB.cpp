@@ -1,42 +1,202 @@
 #include "../../h/Kernel/SCB.hpp"
 #include "../../h/Kernel/Kernel.hpp"
+#include "../../h/Kernel/Timer.hpp"
 
-SCB::SCB(unsigned startValue, bool binary)
+#if LOCK_STATS
+SCB* SCB::allSemaphores = nullptr;
+#endif
+
+SCB::SCB(unsigned startValue, bool binary, bool handoff, WakePolicy policy)
     :
     m_Value((int)startValue),
-    m_Binary(binary)
+    m_Binary(binary),
+    m_Handoff(handoff),
+    m_Policy(policy),
+    m_BlockedQueue(&waiterLeft, this)
+#if LOCK_STATS
+    ,
+    m_CallSite(0),
+    m_Waits(0),
+    m_Blocked(0),
+    m_BlockedTime(0),
+    m_MaxBlockedTime(0),
+    m_QueueLength(0),
+    m_MaxQueueLength(0),
+    m_PrevSemaphore(nullptr),
+    m_NextSemaphore(allSemaphores)
+#endif
 {
+#if LOCK_STATS
+    if(allSemaphores != nullptr) allSemaphores->m_PrevSemaphore = this;
+    allSemaphores = this;
+#endif
 }
 
 SCB::~SCB()
 {
-    while(!m_BlockedQueue.isEmpty())
+    // Threads that are still waiting find out that the semaphore is gone
+    while(!m_BlockedQueue.isEmpty()) m_BlockedQueue.first()->thread->wake(-1);
+
+#if LOCK_STATS
+    if(m_PrevSemaphore != nullptr) m_PrevSemaphore->m_NextSemaphore = m_NextSemaphore;
+    else allSemaphores = m_NextSemaphore;
+    if(m_NextSemaphore != nullptr) m_NextSemaphore->m_PrevSemaphore = m_PrevSemaphore;
+#endif
+}
+
+int SCB::wait(unsigned count)
+{
+    // Binary semaphore never holds more than one unit
+    if(count == 0 || (m_Binary && count > 1)) return -1;
+
+    recordWait();
+    if(canTake(count))
+    {
+        m_Value -= (int)count;
+        return 0;
+    }
+
+    return block(count);
+}
+
+int SCB::tryWait()
+{
+    recordWait();
+    if(canTake(1))
     {
-        auto current = m_BlockedQueue.removeFirst();
-        Scheduler::put(current);
+        m_Value--;
+        return 0;
     }
+
+    return SEM_BUSY;
+}
+
+int SCB::timedWait(uint64 timeout)
+{
+    recordWait();
+    if(canTake(1))
+    {
+        m_Value--;
+        return 0;
+    }
+
+    if(timeout == 0) return SEM_TIMEOUT;
+    return block(1, timeout);
 }
 
-void SCB::wait()
+int SCB::signal(unsigned count)
 {
-    if(--m_Value < 0) block();
+    if(count == 0 || count > (unsigned)(MAX_VALUE - m_Value)) return -1;
+
+    m_Value += (int)count;
+    serveWaiters();
+
+    return 0;
 }
 
-void SCB::signal()
+void SCB::serveWaiters()
 {
-    if(m_Value++ < 0) unblock();
+    // Units go straight to waiting threads in one pass, the value only counts units nobody has taken yet
+    for(auto node = nextWaiter(); node != nullptr && m_Value >= (int)node->count; node = nextWaiter())
+    {
+        m_Value -= (int)node->count;
+        node->thread->wake(0, m_Handoff, node->index);
+    }
+
     if(m_Binary && m_Value > 1) m_Value = 1;
 }
 
-void SCB::block()
+int SCB::block(unsigned count, uint64 timeout)
 {
-    m_BlockedQueue.addLast(TCB::running);
-    TCB::running->m_PutInScheduler = false;
-    thread_dispatch();
+    // Node lives on the stack of the blocked thread, it is only needed until the thread is woken up
+    WaitQueue::Node node(TCB::running, this);
+    node.count = count;
+    m_BlockedQueue.addLast(&node);
+
+#if LOCK_STATS
+    m_Blocked++;
+    if(++m_QueueLength > m_MaxQueueLength) m_MaxQueueLength = m_QueueLength;
+    node.blockedAt = Timer::now();
+#endif
+
+    return TCB::blockQueued(&node, timeout);
+}
+
+void SCB::waiterLeft(void* owner, WaitQueue::Node* node, int status)
+{
+#if LOCK_STATS
+    auto scb = static_cast<SCB*>(owner);
+
+    // Nodes of wait_any aren't counted
+    if(node->blockedAt != 0)
+    {
+        scb->m_QueueLength--;
+        auto blockedTime = Timer::now() - node->blockedAt;
+        scb->m_BlockedTime += blockedTime;
+        if(blockedTime > scb->m_MaxBlockedTime) scb->m_MaxBlockedTime = blockedTime;
+    }
+#else
+    auto scb = static_cast<SCB*>(owner);
+    (void)node;
+#endif
+
+    // Waiter that gave up might have been holding up the ones behind it
+    if(status == SEM_TIMEOUT) scb->serveWaiters();
 }
 
-void SCB::unblock()
+WaitQueue::Node* SCB::nextWaiter() const
 {
-    auto threadToUnblock = m_BlockedQueue.removeFirst();
-    Scheduler::put(threadToUnblock);
+    switch(m_Policy)
+    {
+    case WAKE_LIFO:
+        return m_BlockedQueue.last();
+    case WAKE_PRIORITY:
+    {
+        // Among threads of the same priority the one that waited the longest goes first
+        auto best = m_BlockedQueue.first();
+        for(auto node = best; node != nullptr; node = node->next)
+        {
+            if(node->thread->getPriority() > best->thread->getPriority()) best = node;
+        }
+
+        return best;
+    }
+    default:
+        return m_BlockedQueue.first();
+    }
+}
+
+int SCB::getLockStats(lockstat_t* stats, int count)
+{
+#if LOCK_STATS
+    if(stats == nullptr || count <= 0) return -1;
+
+    // Insertion into the sorted output keeps only the count most contended ones
+    auto filled = 0;
+    for(auto scb = allSemaphores; scb != nullptr; scb = scb->m_NextSemaphore)
+    {
+        auto position = filled;
+        while(position > 0 && stats[position - 1].blocked_time < Timer::toNanoseconds(scb->m_BlockedTime)) position--;
+        if(position == count) continue;
+
+        auto last = (filled < count ? filled : count - 1);
+        for(auto i = last; i > position; i--) stats[i] = stats[i - 1];
+        if(filled < count) filled++;
+
+        stats[position] = {
+            scb,
+            scb->m_CallSite,
+            scb->m_Waits,
+            scb->m_Blocked,
+            Timer::toNanoseconds(scb->m_BlockedTime),
+            Timer::toNanoseconds(scb->m_MaxBlockedTime),
+            scb->m_QueueLength,
+            scb->m_MaxQueueLength
+        };
+    }
+
+    return filled;
+#else
+    return -1;
+#endif
 }
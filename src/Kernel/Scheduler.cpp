@@ -1,23 +1,76 @@
 #include "../../h/Kernel/Scheduler.hpp"
+#include "../../h/Kernel/TCB.hpp"
+#include "../../h/Kernel/Timer.hpp"
+#include "../../h/Kernel/Kernel.hpp"
 
-KernelDeque<TCB*> Scheduler::threadQueue;
+KernelDeque<TCB*> Scheduler::threadQueues[PRIORITY_LEVELS];
+TCB* Scheduler::handoffThread = nullptr;
 
 TCB *Scheduler::get()
 {
-    return threadQueue.removeFirst();
+    // Ready count is kept in the kernel info page, so user code can tell if a dispatch would do anything
+    Kernel::info.runnable--;
+
+    // The handoff thread skips the queue entirely
+    if(handoffThread != nullptr)
+    {
+        auto handle = handoffThread;
+        handoffThread = nullptr;
+        return handle;
+    }
+
+    auto priority = PRIORITY_LEVELS - 1;
+    while(threadQueues[priority].isEmpty()) priority--;
+
+    return threadQueues[priority].removeFirst();
 }
 
 void Scheduler::put(TCB* handle, bool putAtFrontOfQueue)
 {
+    auto wasEmpty = isEmpty();
+
+    auto& threadQueue = threadQueues[handle->getPriority()];
     if(putAtFrontOfQueue) threadQueue.addFirst(handle);
     else threadQueue.addLast(handle);
+    Kernel::info.runnable++;
+
+    // Running thread was alone so the tick is off, it has to be preempted at the end of its time slice now
+    if(wasEmpty) Timer::program();
+}
+
+void Scheduler::handoff(TCB* handle)
+{
+    // Only one thread can hold the handoff slot, the previous one still gets to run first
+    if(handoffThread != nullptr) threadQueues[handoffThread->getPriority()].addFirst(handoffThread);
+    handoffThread = handle;
+    Kernel::info.runnable++;
+}
+
+int Scheduler::remove(TCB* handle)
+{
+    if(handle == nullptr) return -1;
+
+    if(handoffThread == handle)
+    {
+        handoffThread = nullptr;
+        Kernel::info.runnable--;
+        return 0;
+    }
+
+    if(threadQueues[handle->getPriority()].remove(handle) < 0) return -1;
+
+    Kernel::info.runnable--;
+    return 0;
 }
 
 bool Scheduler::contains(TCB *handle)
 {
-    return threadQueue.contains(handle);
+    if(handle == nullptr) return false;
+
+    return handoffThread == handle || threadQueues[handle->getPriority()].contains(handle);
 }
 
 bool Scheduler::isEmpty() {
-    return threadQueue.isEmpty();
+    // Counted on every put and get, so the queues don't have to be looked at
+    return Kernel::info.runnable == 0;
 }
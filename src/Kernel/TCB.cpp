@@ -1,12 +1,23 @@
 #include "../../h/Kernel/TCB.hpp"
 #include "../../h/Kernel/Kernel.hpp"
 #include "../../h/Kernel/SCB.hpp"
+#include "../../h/Kernel/Timer.hpp"
+#include "../../h/Kernel/KernelMutex.hpp"
+#include "../../h/Kernel/KernelTimer.hpp"
 
 KernelDeque<TCB*> TCB::allThreads;
 KernelDeque<TCB*> TCB::suspendedThreads;
 TCB* TCB::running = nullptr;
 
-uint64 TCB::timeSliceCounter = 0;
+uint64 TCB::timeSliceEnd = 0;
+
+#if LATENCY_STATS
+LatencyHistogram TCB::wakeupLatency;
+#endif
+
+TCB* TCB::threadCache = nullptr;
+uint64 TCB::threadCacheSize = 0;
+uint64 TCB::threadCacheLimit = TCB::DEFAULT_THREAD_CACHE_LIMIT;
 
 TCB* TCB::mainThread = nullptr;
 TCB* TCB::idleThread = nullptr;
@@ -16,28 +27,48 @@ TCB* TCB::userThread = nullptr;
 // When creating an initial context, we want ra to point to the body of
 // our thread immediately, and sp will point at the start of the space
 // allocated for the stack
-TCB::TCB(TCB::Body body, void *args, uint64 timeSlice, void *stack, bool kernelThread)
+TCB::TCB(TCB::Body body, void *args, uint64 timeSlice, void *stack, size_t stackSize, bool kernelThread)
     :
     m_Body(body),
     m_Args(args),
     m_Stack(stack),
+    m_StackSize(stackSize),
     m_Context ({
         (uint64)&bodyWrapper,
-        body == nullptr ? 0 : (uint64)( (char*)stack + (DEFAULT_STACK_SIZE + STACK_CONTEXT_EXTENSION) )
+        body == nullptr ? 0 : (uint64)( (char*)stack + stackSize )
     }),
     m_TimeSlice(timeSlice),
+    m_Started(body == nullptr || body == &idleThreadBody),
     m_Finished(false),
-    m_SleepCounter(0),
+    m_TimeoutEntry(&timeoutExpired, this),
+    m_BasePriority(THREAD_PRIORITY_DEFAULT),
+    m_Priority(THREAD_PRIORITY_DEFAULT),
+    m_BlockedOnMutex(nullptr),
+    m_HeldMutexes(nullptr),
+    m_ReadLocks(0),
+    m_Rseq(nullptr),
+    m_WaitNode(nullptr),
+    m_WakeStatus(0),
+    m_WakeIndex(0),
     m_PutInScheduler(true),
-    m_KernelThread(kernelThread)
+    m_KernelThread(kernelThread),
+    m_ExpiredTimers(nullptr),
+    m_ExpiredTimersTail(nullptr),
+    m_WaitingForTimers(false),
+    m_Timers(nullptr),
+    m_NextCached(nullptr)
 {
-    if(body != nullptr && body != &idleThreadBody) Scheduler::put(this, true);
+#if LATENCY_STATS
+    m_WakeupTime = 0;
+#endif
 }
 
 TCB::~TCB()
 {
     allThreads.remove(this);
     suspendedThreads.remove(this);
+    TimerQueue::remove(&m_TimeoutEntry);
+    leaveWaitQueues(-1);
     if(m_Stack != nullptr) MemoryAllocator::free(m_Stack);
 }
 
@@ -67,6 +98,22 @@ void TCB::dispatch()
     if(Scheduler::isEmpty()) running = idleThread;
     else running = Scheduler::get();
 
+    Kernel::info.current_thread = running;
+
+    // Next timer interrupt might be needed earlier or later for the new time slice
+    timeSliceEnd = Timer::now() + running->m_TimeSlice * Timer::TICK_PERIOD;
+    Timer::program();
+
+#if LATENCY_STATS
+    if(running->m_WakeupTime != 0)
+    {
+        auto latency = Timer::toNanoseconds(Timer::now() - running->m_WakeupTime);
+        running->m_WakeupLatency.record(latency);
+        wakeupLatency.record(latency);
+        running->m_WakeupTime = 0;
+    }
+#endif
+
     if(running != old) TCB::contextSwitch(&old->m_Context, &running->m_Context);
 }
 
@@ -77,35 +124,181 @@ int TCB::deleteThread(TCB* handle)
     // Unblock thread that is waiting for this thread to finish
     handle->unblockWaitingThread();
 
+    // Dispatch must not put the deleted thread back in the Scheduler
+    handle->m_Finished = true;
+
+    // Waiters would block forever and the TCB can be reused while it is still recorded as the owner
+    KernelMutex::releaseAll(handle);
+    KernelTimer::detachDispatcher(handle);
+
     auto handleIsRunning = (running == handle);
-    handle->~TCB();
-    MemoryAllocator::free(handle);
+    releaseThread(handle);
 
     // If we are deleting the running thread, change context and don't save old context
-    if(handleIsRunning) thread_dispatch();
+    if(handleIsRunning) yield();
 
     return 0;
 }
 
-TCB* TCB::createThread(TCB::Body body, void* args, void* stack, bool kernelThread)
+TCB* TCB::createThread(TCB::Body body, void* args, void* stack, bool kernelThread, bool suspended, size_t stackSize)
 {
-    auto newTCB = static_cast<TCB*>(MemoryAllocator::alloc(sizeof(TCB)));
+    // Keep the stack pointer aligned to 16 bytes
+    stackSize = ((stackSize + 15) & ~15UL) + STACK_CONTEXT_EXTENSION;
+
+    TCB* newTCB;
+
+    // Threads that don't bring their own stack get one from the kernel, together with the TCB
+    if(stack == nullptr && body != nullptr) newTCB = allocateThread(stack, stackSize);
+    else newTCB = static_cast<TCB*>(MemoryAllocator::alloc(sizeof(TCB)));
+
+    if(newTCB == nullptr) return nullptr;
+    if(stack != nullptr) paintStack(stack, stackSize);
+
     new (newTCB) TCB
     (
         body,
         args,
         DEFAULT_TIME_SLICE,
         stack,
+        stackSize,
         kernelThread
     );
 
     // If we are creating the main thread, set it as running
-    if(body == nullptr) running = newTCB;
+    if(body == nullptr)
+    {
+        running = newTCB;
+        Kernel::info.current_thread = running;
+    }
 
     allThreads.addLast(newTCB);
+
+    // New threads run before everything else in the Scheduler, unless they wait for start()
+    if(!suspended && !newTCB->m_Started) newTCB->start(true);
+
+    return newTCB;
+}
+
+TCB* TCB::allocateThread(void*& stack, size_t stackSize)
+{
+    // Creating a thread is just a pop from the cache if some thread with the same stack size has exited before
+    TCB* previous = nullptr;
+    for(auto cachedTCB = threadCache; cachedTCB != nullptr; cachedTCB = cachedTCB->m_NextCached)
+    {
+        if(cachedTCB->m_StackSize != stackSize)
+        {
+            previous = cachedTCB;
+            continue;
+        }
+
+        if(previous != nullptr) previous->m_NextCached = cachedTCB->m_NextCached;
+        else threadCache = cachedTCB->m_NextCached;
+        threadCacheSize--;
+
+        stack = cachedTCB->m_Stack;
+        return cachedTCB;
+    }
+
+    auto newTCB = static_cast<TCB*>(MemoryAllocator::alloc(sizeof(TCB)));
+    if(newTCB == nullptr) return nullptr;
+
+    stack = MemoryAllocator::alloc(stackSize);
+    if(stack == nullptr)
+    {
+        MemoryAllocator::free(newTCB);
+        return nullptr;
+    }
+
     return newTCB;
 }
 
+void TCB::releaseThread(TCB* handle)
+{
+    allThreads.remove(handle);
+    suspendedThreads.remove(handle);
+
+    // Kernel threads and threads without a stack are never reused
+    if(threadCacheSize < threadCacheLimit && handle->m_Stack != nullptr && !handle->m_KernelThread)
+    {
+        handle->m_NextCached = threadCache;
+        threadCache = handle;
+        threadCacheSize++;
+        return;
+    }
+
+    handle->~TCB();
+    MemoryAllocator::free(handle);
+}
+
+void TCB::setThreadCacheLimit(uint64 limit)
+{
+    threadCacheLimit = limit;
+
+    while(threadCacheSize > threadCacheLimit)
+    {
+        auto cachedTCB = threadCache;
+        threadCache = cachedTCB->m_NextCached;
+        threadCacheSize--;
+
+        cachedTCB->~TCB();
+        MemoryAllocator::free(cachedTCB);
+    }
+}
+
+int TCB::createThreads(TCB** handles, TCB::Body body, void** args, int count, bool suspended)
+{
+    if(handles == nullptr || body == nullptr || count < 0) return -1;
+
+    auto created = 0;
+    while(created < count)
+    {
+        handles[created] = createThread(body, args != nullptr ? args[created] : nullptr, nullptr, false, true);
+        if(handles[created] == nullptr) break;
+        created++;
+    }
+
+    // Release all threads together, behind the ones that are already waiting for the processor
+    if(!suspended)
+    {
+        for(auto i = 0; i < created; i++) handles[i]->start();
+    }
+
+    return created;
+}
+
+void TCB::paintStack(void* stack, size_t stackSize)
+{
+    auto words = static_cast<uint64*>(stack);
+    for(size_t i = 0; i < stackSize / sizeof(uint64); i++) words[i] = STACK_PAINT_PATTERN;
+}
+
+int TCB::getStackUsage(size_t* used, size_t* size) const
+{
+    if(m_Stack == nullptr || used == nullptr || size == nullptr) return -1;
+
+    // Stack grows down, so everything from the bottom that still has the pattern was never touched
+    auto words = static_cast<uint64*>(m_Stack);
+    size_t untouchedWords = 0;
+    while(untouchedWords < m_StackSize / sizeof(uint64) && words[untouchedWords] == STACK_PAINT_PATTERN)
+    {
+        untouchedWords++;
+    }
+
+    *used = m_StackSize - untouchedWords * sizeof(uint64);
+    *size = m_StackSize;
+    return 0;
+}
+
+int TCB::start(bool putAtFrontOfQueue)
+{
+    // Thread can only be started once
+    if(m_Started) return -1;
+
+    m_Started = true;
+    Scheduler::put(this, putAtFrontOfQueue);
+    return 0;
+}
+
 void TCB::waitForThread(TCB* handle)
 {
     // Can't wait for current thread, check if thread exists
@@ -119,7 +312,7 @@ void TCB::waitForThread(TCB* handle)
 
     // Change context
     running->m_PutInScheduler = false;
-    thread_dispatch();
+    yield();
 }
 
 void TCB::unblockWaitingThread()
@@ -139,13 +332,144 @@ void TCB::unblockWaitingThread()
 int TCB::sleep(uint64 time)
 {
     // If thread is already asleep, return -1
-    if(TCB::running->m_SleepCounter > 0) return -1;
+    if(TCB::running->m_TimeoutEntry.queued) return -1;
     if(time == 0) return 0;
 
-    TCB::running->m_SleepCounter = time;
+    TimerQueue::insert(&TCB::running->m_TimeoutEntry, time);
     TCB::running->m_PutInScheduler = false;
-    thread_dispatch();
+    yield();
+    return 0;
+}
+
+int TCB::yieldTo(TCB* handle)
+{
+    if(handle == running) return 0;
+
+    // Only a thread that is ready to run can take over the processor
+    if(Scheduler::remove(handle) < 0) return -1;
+
+    // Running thread goes to the back of the queue, the target runs next without waiting in it
+    Scheduler::handoff(handle);
+    yield();
+    return 0;
+}
+
+int TCB::setPriority(TCB* handle, int priority)
+{
+    if(handle == nullptr || priority < THREAD_PRIORITY_MIN || priority > THREAD_PRIORITY_MAX) return -1;
+
+    handle->m_BasePriority = priority;
+    KernelMutex::updatePriority(handle);
+
+    return 0;
+}
+
+uint64 TCB::abortSequence(uint64 pc)
+{
+    if(m_Rseq == nullptr || m_Rseq->cs == nullptr) return pc;
+
+    // Descriptor only covers one entry into the sequence, the thread sets it again on the next one
+    auto cs = m_Rseq->cs;
+    m_Rseq->cs = nullptr;
+
+    // Unsigned difference also rejects a pc below the start
+    if(pc - cs->start_ip >= cs->post_commit_offset) return pc;
+
+    return cs->abort_ip;
+}
+
+void TCB::setEffectivePriority(int priority)
+{
+    if(priority == m_Priority) return;
+
+    // Ready threads wait in the queue of their priority, so they have to move
+    if(Scheduler::remove(this) == 0)
+    {
+        m_Priority = priority;
+        Scheduler::put(this);
+    }
+    else m_Priority = priority;
+}
+
+void TCB::timeoutExpired(TimerQueue::Entry* entry)
+{
+    auto thread = static_cast<TCB*>(entry->owner);
+
+    // Thread that was blocked with a timeout gives up waiting, a sleeping thread ignores the status
+    thread->wake(SEM_TIMEOUT);
+}
+
+int TCB::block(WaitQueue* queue, const void* key, uint64 timeout)
+{
+    auto thread = running;
+
+    // Node lives on the stack of the blocked thread, it is only needed until the thread is woken up
+    WaitQueue::Node node(thread, key);
+    queue->addLast(&node);
+
+    return blockQueued(&node, timeout);
+}
+
+int TCB::blockQueued(WaitQueue::Node* nodes, uint64 timeout)
+{
+    auto thread = running;
+    thread->m_WaitNode = nodes;
+
+    if(timeout != 0) TimerQueue::insert(&thread->m_TimeoutEntry, timeout);
+
+    thread->m_PutInScheduler = false;
+    yield();
+
+    return thread->m_WakeStatus;
+}
+
+void TCB::wake(int status, bool handoff, int index)
+{
+    leaveWaitQueues(status);
+
+    m_WakeStatus = status;
+    m_WakeIndex = index;
+    TimerQueue::remove(&m_TimeoutEntry);
+    markWakeup();
+
+    if(handoff) Scheduler::handoff(this);
+    else Scheduler::put(this);
+}
+
+void TCB::leaveWaitQueues(int status)
+{
+    for(auto node = m_WaitNode; node != nullptr; node = node->sibling)
+    {
+        auto queue = node->queue;
+        if(queue == nullptr) continue;
+
+        queue->remove(node);
+        queue->left(node, status);
+    }
+
+    m_WaitNode = nullptr;
+}
+
+void TCB::markWakeup()
+{
+#if LATENCY_STATS
+    m_WakeupTime = Timer::now();
+#endif
+}
+
+int TCB::getLatencyStats(TCB* handle, latency_stats_t* stats)
+{
+#if LATENCY_STATS
+    if(stats == nullptr) return -1;
+
+    if(handle == nullptr) wakeupLatency.getStats(stats);
+    else if(allThreads.contains(handle)) handle->m_WakeupLatency.getStats(stats);
+    else return -1;
+
     return 0;
+#else
+    return -1;
+#endif
 }
 
 [[noreturn]] void TCB::idleThreadBody(void*)
@@ -154,10 +478,16 @@ int TCB::sleep(uint64 time)
 
     while(true)
     {
+        // Check the Scheduler with interrupts disabled so a wakeup can't slip in before wfi,
+        // wfi still returns once an interrupt is pending and the interrupt is taken after unlock
+        Kernel::lock();
+        if(Scheduler::isEmpty()) Kernel::waitForInterrupt();
+        Kernel::unlock();
+
         if(!Scheduler::isEmpty())
         {
             TCB::running->m_PutInScheduler = false;
-            thread_dispatch();
+            yield();
         }
     }
 }
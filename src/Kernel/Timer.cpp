@@ -0,0 +1,49 @@
+#include "../../h/Kernel/Timer.hpp"
+#include "../../h/Kernel/TimerQueue.hpp"
+#include "../../h/Kernel/Scheduler.hpp"
+#include "../../h/Kernel/TCB.hpp"
+#include "../../h/Kernel/Kernel.hpp"
+
+// Machine timer scratch area of hw.lib, [3] is the address of mtimecmp and [4] is the period the machine
+// timer handler adds to it before it forwards the interrupt as a supervisor software interrupt
+extern "C" uint64 timer_scratch[][5];
+
+void Timer::initialize()
+{
+    Kernel::info.time = (uint64 volatile*)CLINT_MTIME;
+    Kernel::info.timebase_frequency = TIMEBASE_FREQUENCY;
+    Kernel::info.tick_period = TICK_PERIOD;
+
+#if TIMER_SSTC
+    // Supervisor timer interrupts come directly, the forwarded machine timer isn't needed
+    *((uint64 volatile*)timer_scratch[0][3]) = ~0UL;
+#else
+    // If the kernel doesn't program the timer in time, the machine handler keeps ticking at this rate
+    timer_scratch[0][4] = TICK_PERIOD;
+#endif
+
+    setCompare(now() + TICK_PERIOD);
+}
+
+void Timer::program()
+{
+    auto next = now() + MAX_IDLE_PERIOD;
+
+    // Tick is only needed when there is someone to preempt the running thread for
+    if(!Scheduler::isEmpty() && TCB::timeSliceEnd < next) next = TCB::timeSliceEnd;
+
+    uint64 expiry;
+    if(TimerQueue::nextExpiry(expiry) && expiry < next) next = expiry;
+
+    setCompare(next);
+}
+
+void Timer::setCompare(uint64 time)
+{
+#if TIMER_SSTC
+    // stimecmp, pending interrupt is cleared once the compare value is in the future
+    __asm__ volatile ("csrw 0x14D, %[time]" : : [time] "r"(time));
+#else
+    *((uint64 volatile*)timer_scratch[0][3]) = time;
+#endif
+}
@@ -0,0 +1,112 @@
+#include "../../h/Kernel/TimerQueue.hpp"
+#include "../../h/Kernel/Timer.hpp"
+
+TimerQueue::Entry* TimerQueue::head = nullptr;
+uint64 TimerQueue::lastUpdate = 0;
+
+void TimerQueue::insert(Entry* entry, uint64 delay)
+{
+    if(entry->queued) remove(entry);
+
+    // Deltas count from the last update, not from now
+    auto time = delay + (Timer::now() - lastUpdate);
+
+    // Entries that expire at the same time keep the order in which they were inserted
+    Entry* prev = nullptr;
+    auto cur = head;
+    while(cur != nullptr && cur->delta <= time)
+    {
+        time -= cur->delta;
+        prev = cur;
+        cur = cur->next;
+    }
+
+    entry->delta = time;
+    entry->prev = prev;
+    entry->next = cur;
+    entry->queued = true;
+
+    if(cur != nullptr)
+    {
+        cur->delta -= time;
+        cur->prev = entry;
+    }
+
+    if(prev != nullptr) prev->next = entry;
+    else
+    {
+        head = entry;
+
+        // New nearest timeout, the timer might be programmed for later
+        Timer::program();
+    }
+}
+
+void TimerQueue::remove(Entry* entry)
+{
+    if(!entry->queued) return;
+
+    // The entry after this one now counts from the entry before
+    if(entry->next != nullptr)
+    {
+        entry->next->delta += entry->delta;
+        entry->next->prev = entry->prev;
+    }
+
+    if(entry->prev != nullptr) entry->prev->next = entry->next;
+    else head = entry->next;
+
+    entry->prev = nullptr;
+    entry->next = nullptr;
+    entry->queued = false;
+}
+
+void TimerQueue::update()
+{
+    auto current = Timer::now();
+    auto elapsed = current - lastUpdate;
+    lastUpdate = current;
+
+    // Take out everything that is due first, callbacks can insert entries again
+    Entry* expired = nullptr;
+    Entry* expiredTail = nullptr;
+    while(head != nullptr && head->delta <= elapsed)
+    {
+        elapsed -= head->delta;
+
+        auto entry = head;
+        head = entry->next;
+        if(head != nullptr) head->prev = nullptr;
+
+        entry->next = nullptr;
+        entry->queued = false;
+
+        if(expiredTail != nullptr) expiredTail->next = entry;
+        else expired = entry;
+        expiredTail = entry;
+    }
+
+    if(head != nullptr) head->delta -= elapsed;
+
+    while(expired != nullptr)
+    {
+        auto entry = expired;
+        expired = entry->next;
+        entry->next = nullptr;
+
+        entry->expire(entry);
+    }
+}
+
+bool TimerQueue::nextExpiry(uint64& time)
+{
+    if(head == nullptr) return false;
+
+    time = lastUpdate + head->delta;
+    return true;
+}
+
+bool TimerQueue::isEmpty()
+{
+    return head == nullptr;
+}
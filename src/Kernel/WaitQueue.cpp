@@ -0,0 +1,59 @@
+#include "../../h/Kernel/WaitQueue.hpp"
+
+WaitQueue::WaitQueue(LeaveHandler leaveHandler, void* owner)
+    :
+    head(nullptr),
+    tail(nullptr),
+    leaveHandler(leaveHandler),
+    owner(owner)
+{
+}
+
+void WaitQueue::addLast(Node* node)
+{
+    node->prev = tail;
+    node->next = nullptr;
+    node->queue = this;
+
+    if(tail != nullptr) tail->next = node;
+    else head = node;
+    tail = node;
+}
+
+WaitQueue::Node* WaitQueue::removeFirst()
+{
+    auto node = head;
+    if(node != nullptr) remove(node);
+
+    return node;
+}
+
+void WaitQueue::remove(Node* node)
+{
+    if(node->queue != this) return;
+
+    if(node->prev != nullptr) node->prev->next = node->next;
+    else head = node->next;
+
+    if(node->next != nullptr) node->next->prev = node->prev;
+    else tail = node->prev;
+
+    node->prev = nullptr;
+    node->next = nullptr;
+    node->queue = nullptr;
+}
+
+WaitQueue::Node* WaitQueue::first() const
+{
+    return head;
+}
+
+WaitQueue::Node* WaitQueue::last() const
+{
+    return tail;
+}
+
+bool WaitQueue::isEmpty() const
+{
+    return head == nullptr;
+}
@@ -14,7 +14,9 @@
 _ZN6Kernel14supervisorTrapEv:
     j ecallTrap
     j timerTrap
-    .skip 28
+    .skip 12
+    j timerTrap
+    .skip 12
     j externalTrap
 
 ecallTrap:
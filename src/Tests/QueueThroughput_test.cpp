@@ -0,0 +1,119 @@
+#include "../../h/C++_API/syscall_cpp.hpp"
+#include "../../h/C++_API/queue_cpp.hpp"
+#include "../../h/Tests/QueueThroughput_test.hpp"
+
+#include "../../h/Tests/buffer.hpp"
+#include "../../h/Tests/buffer_CPP_API.hpp"
+#include "../../h/Tests/printing.hpp"
+
+// Same number of items goes through the semaphore buffers and the lock-free queues, the semaphore
+// buffers trap four times per item while the queues only trap to wait when they are empty or full
+
+static const int itemCount = 6000;
+static const int queueCapacity = 64;
+
+template<typename Queue>
+struct Worker
+{
+    Queue* queue;
+    int items;
+    volatile uint64 sum;
+};
+
+template<typename Queue>
+static void producerBody(void* arg)
+{
+    Worker<Queue>* worker = (Worker<Queue>*)arg;
+    for (int i = 1; i <= worker->items; i++) worker->queue->push(i);
+}
+
+template<typename Queue>
+static void consumerBody(void* arg)
+{
+    Worker<Queue>* worker = (Worker<Queue>*)arg;
+    for (int i = 0; i < worker->items; i++) {
+        int item;
+        worker->queue->pop(item);
+        worker->sum += item;
+    }
+}
+
+// Semaphore buffers under the same interface as the queues
+struct BufferQueue
+{
+    Buffer buffer;
+    BufferQueue() : buffer(queueCapacity) { }
+    void push(int item) { buffer.put(item); }
+    void pop(int& item) { item = buffer.get(); }
+};
+
+struct BufferCPPQueue
+{
+    BufferCPP buffer;
+    BufferCPPQueue() : buffer(queueCapacity) { }
+    void push(int item) { buffer.put(item); }
+    void pop(int& item) { item = buffer.get(); }
+};
+
+template<typename Queue>
+static void measure(const char* name, Queue* queue, int producerCount, int consumerCount)
+{
+    const int maxThreads = 4;
+    Worker<Queue> producers[maxThreads];
+    Worker<Queue> consumers[maxThreads];
+    thread_t producerThreads[maxThreads];
+    thread_t consumerThreads[maxThreads];
+
+    uint64 start = time_now_ns();
+
+    for (int i = 0; i < consumerCount; i++) {
+        consumers[i] = {queue, itemCount / consumerCount, 0};
+        thread_create(&consumerThreads[i], consumerBody<Queue>, consumers + i);
+    }
+
+    for (int i = 0; i < producerCount; i++) {
+        producers[i] = {queue, itemCount / producerCount, 0};
+        thread_create(&producerThreads[i], producerBody<Queue>, producers + i);
+    }
+
+    for (int i = 0; i < producerCount; i++) thread_join(producerThreads[i]);
+    for (int i = 0; i < consumerCount; i++) thread_join(consumerThreads[i]);
+
+    uint64 elapsed = time_now_ns() - start;
+
+    // Every producer sends 1..items, so the consumers together have to see all of them
+    uint64 sum = 0;
+    for (int i = 0; i < consumerCount; i++) sum += consumers[i].sum;
+
+    uint64 itemsPerProducer = itemCount / producerCount;
+    uint64 expected = producerCount * itemsPerProducer * (itemsPerProducer + 1) / 2;
+
+    printString(name);
+    printString(": "); printInt(elapsed / 1000);
+    printString(" us, "); printInt(itemCount * 1000000ULL / (elapsed / 1000 + 1));
+    printString(" items/s");
+    if (sum != expected) printString(", ITEMS LOST");
+    printString("\n");
+}
+
+void testQueueThroughput()
+{
+    // Every run takes out all the items it puts in, so the queues are empty again and can be reused.
+    // The buffers print themselves when they are deleted, so that waits until all results are printed
+    BufferQueue* bufferQueue = new BufferQueue();
+    BufferCPPQueue* bufferCPPQueue = new BufferCPPQueue();
+    SpscQueue<int, queueCapacity>* spscQueue = new SpscQueue<int, queueCapacity>();
+    MpmcQueue<int, queueCapacity>* mpmcQueue = new MpmcQueue<int, queueCapacity>();
+
+    measure("Buffer (C API semaphores) 1:1", bufferQueue, 1, 1);
+    measure("BufferCPP (C++ API semaphores) 1:1", bufferCPPQueue, 1, 1);
+    measure("SpscQueue 1:1", spscQueue, 1, 1);
+    measure("MpmcQueue 1:1", mpmcQueue, 1, 1);
+    measure("MpmcQueue 2:2", mpmcQueue, 2, 2);
+    measure("Buffer (C API semaphores) 2:2", bufferQueue, 2, 2);
+
+    delete spscQueue;
+    delete mpmcQueue;
+    delete bufferQueue;
+    delete bufferCPPQueue;
+}
@@ -0,0 +1,97 @@
+#include "../../h/C_API/syscall_c.hpp"
+#include "../../h/Tests/WakePolicy_test.hpp"
+
+#include "../../h/Tests/printing.hpp"
+
+// Worker pool that waits for jobs on one semaphore, the producer hands out a batch of jobs and waits for
+// all of them to finish. With LIFO the same few workers take most of the jobs while their data is still
+// in cache, FIFO spreads the jobs over the whole pool and PRIORITY prefers the more important workers
+
+static const int workerCount = 8;
+static const int jobCount = 2000;
+static const int batchSize = 4;
+static const int workerDataSize = 2048;
+
+static sem_t jobs;
+static sem_t done;
+static volatile bool stopWorkers = false;
+
+static int jobsDone[workerCount];
+static char workerData[workerCount][workerDataSize];
+
+static void workerBody(void* arg)
+{
+    int id = *((int*)arg);
+
+    while (true) {
+        sem_wait(jobs);
+        if (stopWorkers) break;
+
+        // Job walks over the worker's own data
+        unsigned sum = 0;
+        for (int i = 0; i < workerDataSize; i++) sum += workerData[id][i]++;
+        workerData[id][0] = (char)sum;
+
+        jobsDone[id]++;
+        sem_signal(done);
+    }
+}
+
+static void runPool(const char* name, unsigned flags)
+{
+    int ids[workerCount];
+    thread_t workers[workerCount];
+
+    sem_open_flags(&jobs, 0, flags);
+    sem_open(&done, 0);
+    stopWorkers = false;
+
+    for (int i = 0; i < workerCount; i++) {
+        ids[i] = i;
+        jobsDone[i] = 0;
+
+        // Every other worker is less important, it only matters for PRIORITY
+        thread_create_flags(&workers[i], workerBody, ids + i, THREAD_SUSPENDED);
+        thread_set_priority(workers[i], THREAD_PRIORITY_DEFAULT - (i % 2));
+        thread_start(workers[i]);
+    }
+
+    // Let all workers block on the semaphore before measuring, the less important ones only run once we sleep
+    time_sleep(1);
+
+    uint64 start = time_now_ns();
+    for (int job = 0; job < jobCount; job += batchSize) {
+        sem_signal_n(jobs, batchSize);
+        sem_wait_n(done, batchSize);
+    }
+    uint64 elapsed = time_now_ns() - start;
+
+    stopWorkers = true;
+    sem_signal_n(jobs, workerCount);
+    for (int i = 0; i < workerCount; i++) thread_join(workers[i]);
+
+    sem_close(jobs);
+    sem_close(done);
+
+    int workersUsed = 0;
+    for (int i = 0; i < workerCount; i++) {
+        if (jobsDone[i] > 0) workersUsed++;
+    }
+
+    printString(name);
+    printString(": "); printInt(elapsed / 1000);
+    printString(" us, "); printInt(jobCount * 1000000ULL / (elapsed / 1000 + 1));
+    printString(" jobs/s, workers used "); printInt(workersUsed);
+    printString(", jobs per worker");
+    for (int i = 0; i < workerCount; i++) {
+        printString(" "); printInt(jobsDone[i]);
+    }
+    printString("\n");
+}
+
+void testWakePolicy()
+{
+    runPool("FIFO", 0);
+    runPool("LIFO", SEM_LIFO);
+    runPool("PRIORITY", SEM_PRIORITY);
+}
@@ -0,0 +1,89 @@
+#include "../../h/C_API/syscall_c.hpp"
+#include "../../h/Tests/WakeupLatency_test.hpp"
+
+#include "../../h/Tests/printing.hpp"
+
+// Periodic threads sleep for a few ticks at a time while load threads keep the processor busy,
+// wakeup latency is how long a periodic thread waits for the processor after its sleep expires
+
+static const int periodicThreadCount = 3;
+static const int loadThreadCount = 2;
+static const time_t testDuration = 100;
+
+static volatile bool stopTest = false;
+
+static void periodicBody(void* arg)
+{
+    time_t period = *((time_t*)arg);
+
+    while (!stopTest) {
+        for (volatile int i = 0; i < 1000; i++) { /* activation */ }
+        time_sleep(period);
+    }
+}
+
+static void loadBody(void* arg)
+{
+    while (!stopTest) {
+        for (volatile int i = 0; i < 1000; i++) { /* busy wait */ }
+    }
+}
+
+static void printStats(const char* name, latency_stats_t* stats, bool printHistogram)
+{
+    printString(name);
+    printString(": samples="); printInt(stats->samples);
+    printString(" avg="); printInt(stats->average);
+    printString(" p50<="); printInt(stats->p50);
+    printString(" p90<="); printInt(stats->p90);
+    printString(" p99<="); printInt(stats->p99);
+    printString(" max="); printInt(stats->max);
+    printString(" ns\n");
+
+    if (!printHistogram) return;
+
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        if (stats->buckets[i] == 0) continue;
+
+        printString("  >= "); printInt(1UL << i);
+        printString(" ns: "); printInt(stats->buckets[i]);
+        printString("\n");
+    }
+}
+
+void testWakeupLatency()
+{
+    latency_stats_t stats;
+    if (thread_latency_stats(nullptr, &stats) < 0) {
+        printString("Kernel is built without LATENCY_STATS\n");
+        return;
+    }
+
+    time_t periods[periodicThreadCount] = {1, 2, 5};
+    thread_t periodicThreads[periodicThreadCount];
+    thread_t loadThreads[loadThreadCount];
+
+    for (int i = 0; i < periodicThreadCount; i++) {
+        thread_create(&periodicThreads[i], periodicBody, periods + i);
+    }
+
+    for (int i = 0; i < loadThreadCount; i++) {
+        thread_create(&loadThreads[i], loadBody, nullptr);
+    }
+
+    time_sleep(testDuration);
+    stopTest = true;
+
+    // Threads are still alive until they notice stopTest, so their statistics can be read
+    for (int i = 0; i < periodicThreadCount; i++) {
+        printString("Period "); printInt(periods[i]);
+        if (thread_latency_stats(periodicThreads[i], &stats) == 0) printStats("", &stats, false);
+        else printString(": finished\n");
+    }
+
+    for (int i = 0; i < periodicThreadCount; i++) thread_join(periodicThreads[i]);
+    for (int i = 0; i < loadThreadCount; i++) thread_join(loadThreads[i]);
+
+    thread_latency_stats(nullptr, &stats);
+    printStats("System", &stats, true);
+}
@@ -27,14 +27,20 @@
 // TEST 6 (zadatak 4. CPP API i asinhrona promena konteksta)
 #include "../../h/Tests/ConsumerProducer_CPP_API_test.hpp"
 #include "../../h/Tests/System_Mode_test.hpp"
+// TEST 8 (wakeup latency histogram)
+#include "../../h/Tests/WakeupLatency_test.hpp"
+// TEST 9 (semaphore wake policies on a worker pool)
+#include "../../h/Tests/WakePolicy_test.hpp"
+// TEST 10 (lock-free queues against semaphore buffers)
+#include "../../h/Tests/QueueThroughput_test.hpp"
 
 #endif
 
 void userMain()
 {
-    printString("Unesite broj testa? [1-7]\n");
-    int test = getc() - '0';
-    getc(); // Enter posle broja
+    printString("Unesite broj testa? [1-10]\n");
+    int test = 0;
+    for (char c = getc(); c >= '0' && c <= '9'; c = getc()) test = test * 10 + c - '0'; // do Enter posle broja
 
     if ((test >= 1 && test <= 2) || test == 7) {
         if (LEVEL_2_IMPLEMENTED == 0) {
@@ -50,7 +56,7 @@ void userMain()
         }
     }
 
-    if (test >= 5 && test <= 6) {
+    if ((test >= 5 && test <= 6) || test >= 8) {
         if (LEVEL_4_IMPLEMENTED == 0) {
             printString("Nije navedeno da je zadatak 4 implementiran\n");
             return;
@@ -99,6 +105,24 @@ void userMain()
             System_Mode_test();
             printString("Test se nije uspesno zavrsio\n");
             printString("TEST 7 (zadatak 2., testiranje da li se korisnicki kod izvrsava u korisnickom rezimu)\n");
+#endif
+            break;
+        case 8:
+#if LEVEL_4_IMPLEMENTED == 1
+            testWakeupLatency();
+            printString("TEST 8 (wakeup latency histogram)\n");
+#endif
+            break;
+        case 9:
+#if LEVEL_4_IMPLEMENTED == 1
+            testWakePolicy();
+            printString("TEST 9 (semaphore wake policies on a worker pool)\n");
+#endif
+            break;
+        case 10:
+#if LEVEL_4_IMPLEMENTED == 1
+            testQueueThroughput();
+            printString("TEST 10 (lock-free queues against semaphore buffers)\n");
 #endif
             break;
         default: